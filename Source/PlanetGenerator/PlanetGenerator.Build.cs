@@ -27,6 +27,8 @@ public class PlanetGenerator : ModuleRules
 			{
 				"Core",
 				"ProceduralMeshComponent",
+				"DeveloperSettings",
+				"RenderCore",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -39,9 +41,25 @@ public class PlanetGenerator : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"MeshDescription",
+				"StaticMeshDescription",
+				"RHI",
+				"PhysicsCore",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
+
+		// BakeToStaticMesh creates and saves assets
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.AddRange(
+				new string[]
+				{
+					"UnrealEd",
+					"AssetRegistry",
+				}
+				);
+		}
 		
 		
 		DynamicallyLoadedModuleNames.AddRange(
@@ -2,13 +2,26 @@
 #include "SimplexNoiseBPLibrary.h"
 #include "KismetProceduralMeshLibrary.h"
 #include "Materials/MaterialInstanceDynamic.h"
+#include "PlanetMaterialGenerator.h"
 #include "Engine/Engine.h"
 #include "DrawDebugHelpers.h"
+#include "Components/SphereComponent.h"
+#include "Components/MaterialBillboardComponent.h"
+#include "TimerManager.h"
+#include "PlanetSubsystem.h"
+#include "PlanetMeshBuilder.h"
+#include "PlanetMeshComponent.h"
+#include "PlanetGeneratorSettings.h"
+#include "PlanetCalibration.h"
+#include "PlanetStaticMeshExport.h"
 #include <Kismet/GameplayStatics.h>
 
 APlanetActor::APlanetActor()
 {
+	// Rotation and orbits run in UPlanetSubsystem; the actor only ticks while a tile is selected,
+	// or always when a Blueprint subclass implements Event Tick (see BeginPlay)
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	PlanetMesh = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("PlanetMesh"));
 	RootComponent = PlanetMesh;
@@ -20,10 +33,49 @@ APlanetActor::APlanetActor()
 	PlanetMesh->SetCollisionResponseToAllChannels(ECR_Block);
 	PlanetMesh->SetGenerateOverlapEvents(true);
 
+	// The ocean only answers visibility traces so tile selection works over water,
+	// while pawns and physics still collide with the sea floor
+	OceanMesh = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("OceanMesh"));
+	OceanMesh->SetupAttachment(PlanetMesh);
+	OceanMesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	OceanMesh->SetCollisionResponseToAllChannels(ECR_Ignore);
+	OceanMesh->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
+	OceanMesh->bUseComplexAsSimpleCollision = true;
+
+	// Empty unless UsePlanetMeshComponent is set; collides only in RenderMesh collision mode
+	PlanetSurface = CreateDefaultSubobject<UPlanetMeshComponent>(TEXT("PlanetSurface"));
+	PlanetSurface->SetupAttachment(PlanetMesh);
+	PlanetSurface->SetCollisionProfileName(TEXT("BlockAll"));
+	PlanetSurface->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	// Only enabled in Sphere collision mode
+	CollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionSphere"));
+	CollisionSphere->SetupAttachment(PlanetMesh);
+	CollisionSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	CollisionSphere->SetCollisionResponseToAllChannels(ECR_Block);
+
+	// Empty until an impostor atlas has been captured
+	ImpostorBillboard = CreateDefaultSubobject<UMaterialBillboardComponent>(TEXT("ImpostorBillboard"));
+	ImpostorBillboard->SetupAttachment(PlanetMesh);
+	ImpostorBillboard->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	ImpostorBillboard->SetCastShadow(false);
+	ImpostorBillboard->SetHiddenInGame(true);
+	ImpostorBillboard->SetVisibility(false);
+
 	// Add default noise layer
 	FNoiseLayer DefaultLayer;
 	NoiseLayers.Add(DefaultLayer);
 
+	// Default movement costs; water is impassable for land units
+	BiomeMovementCosts.Add(EBiomeType::Ocean, 0.0f);
+	BiomeMovementCosts.Add(EBiomeType::Beach, 1.0f);
+	BiomeMovementCosts.Add(EBiomeType::Desert, 1.25f);
+	BiomeMovementCosts.Add(EBiomeType::Plains, 1.0f);
+	BiomeMovementCosts.Add(EBiomeType::Forest, 1.5f);
+	BiomeMovementCosts.Add(EBiomeType::Mountains, 3.0f);
+	BiomeMovementCosts.Add(EBiomeType::SnowCapped, 4.0f);
+	BiomeMovementCosts.Add(EBiomeType::Tundra, 1.25f);
+
 	// Add default biomes
 	FBiomeSettings OceanBiome;
 	OceanBiome.BiomeType = EBiomeType::Ocean;
@@ -93,12 +145,17 @@ void APlanetActor::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Make sure collision is enabled
+	if (HasScriptTick())
+	{
+		SetActorTickEnabled(true);
+	}
+
+	RefreshMotion();
+
+	// Make sure collision matches the collision mode
 	if (PlanetMesh)
 	{
-		PlanetMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-		PlanetMesh->SetCollisionResponseToAllChannels(ECR_Block);
-		PlanetMesh->SetGenerateOverlapEvents(true);
+		ApplyCollisionSettings();
 
 		// Log collision settings
 		UE_LOG(LogTemp, Log, TEXT("Planet collision enabled: %s"),
@@ -108,13 +165,37 @@ void APlanetActor::BeginPlay()
 	}
 }
 
+void APlanetActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWorld* World = GetWorld())
+	{
+		if (UPlanetSubsystem* Subsystem = World->GetSubsystem<UPlanetSubsystem>())
+		{
+			Subsystem->RemovePlanet(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void APlanetActor::RefreshMotion()
+{
+	if (UWorld* World = GetWorld())
+	{
+		if (UPlanetSubsystem* Subsystem = World->GetSubsystem<UPlanetSubsystem>())
+		{
+			Subsystem->UpdatePlanet(this);
+		}
+	}
+}
+
 void APlanetActor::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
 
 	if (AutoUpdate)
 	{
-		GeneratePlanet();
+		RequestGeneration();
 	}
 }
 
@@ -122,382 +203,1160 @@ void APlanetActor::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	// Handle auto rotation if enabled
-	if (AutoRotate)
+	// Keep the outline on the selected triangle while the planet moves
+	if (SelectedTileIndex >= 0 && SelectedTriangleVertices.Num() == 3)
 	{
-		FRotator NewRotation = GetActorRotation();
-		float RotationAmount = RotationSpeed * DeltaTime;
-		FQuat QuatRotation = FQuat(RotationAxis, FMath::DegreesToRadians(RotationAmount));
-		AddActorLocalRotation(QuatRotation);
+		// Draw debug lines around the selected triangle in its current position
+		FVector V1 = GetActorTransform().TransformPosition(SelectedTriangleVertices[0]);
+		FVector V2 = GetActorTransform().TransformPosition(SelectedTriangleVertices[1]);
+		FVector V3 = GetActorTransform().TransformPosition(SelectedTriangleVertices[2]);
+
+		DrawDebugLine(GetWorld(), V1, V2, FColor::Yellow, false, 0.0f, 0, 3.0f);
+		DrawDebugLine(GetWorld(), V2, V3, FColor::Yellow, false, 0.0f, 0, 3.0f);
+		DrawDebugLine(GetWorld(), V3, V1, FColor::Yellow, false, 0.0f, 0, 3.0f);
+	}
+	else if (!HasScriptTick())
+	{
+		SetActorTickEnabled(false);
+	}
+}
 
-		// If we have a selected tile, update its visual
-		if (SelectedTileIndex >= 0 && SelectedTriangleVertices.Num() == 3)
+bool APlanetActor::HasScriptTick() const
+{
+	return GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AActor, ReceiveTick));
+}
+
+void APlanetActor::GeneratePlanet()
+{
+	// Synchronous path: build on the calling thread and apply straight away
+	if (UWorld* World = GetWorld())
+	{
+		if (UPlanetSubsystem* Subsystem = World->GetSubsystem<UPlanetSubsystem>())
 		{
-			// Draw debug lines around the selected triangle in its current position
-			FVector V1 = GetActorTransform().TransformPosition(SelectedTriangleVertices[0]);
-			FVector V2 = GetActorTransform().TransformPosition(SelectedTriangleVertices[1]);
-			FVector V3 = GetActorTransform().TransformPosition(SelectedTriangleVertices[2]);
+			Subsystem->CancelGeneration(this);
+		}
+	}
 
-			DrawDebugLine(GetWorld(), V1, V2, FColor::Yellow, false, 0.0f, 0, 3.0f);
-			DrawDebugLine(GetWorld(), V2, V3, FColor::Yellow, false, 0.0f, 0, 3.0f);
-			DrawDebugLine(GetWorld(), V3, V1, FColor::Yellow, false, 0.0f, 0, 3.0f);
+	FPlanetMeshBuilder Builder(BeginGeneration());
+	TSharedPtr<FPlanetBuildResult> Result = TakeBuildResult();
+	Builder.Build(*Result);
+
+	ApplyBuildResult(MoveTemp(*Result));
+	RecycleBuildResult(Result);
+}
+
+TSharedPtr<FPlanetBuildResult> APlanetActor::TakeBuildResult()
+{
+	TSharedPtr<FPlanetBuildResult> Result = MoveTemp(RecycledBuildResult);
+	return Result.IsValid() ? Result : MakeShared<FPlanetBuildResult>();
+}
+
+void APlanetActor::RecycleBuildResult(TSharedPtr<FPlanetBuildResult> Result)
+{
+	RecycledBuildResult = MoveTemp(Result);
+	RecycledTime = FPlatformTime::Seconds();
+}
+
+int64 APlanetActor::GetRecycledMemorySize() const
+{
+	int64 Size = (int64)PlanetSurface->GetRetiredStreamsAllocatedSize();
+	if (RecycledBuildResult.IsValid())
+	{
+		Size += (int64)RecycledBuildResult->GetAllocatedSize();
+	}
+	return Size;
+}
+
+double APlanetActor::GetRecycledAge() const
+{
+	return RecycledBuildResult.IsValid() ? FPlatformTime::Seconds() - RecycledTime : -1.0;
+}
+
+void APlanetActor::ReleaseRecycledBuildResult()
+{
+	RecycledBuildResult.Reset();
+	PlanetSurface->ReleaseRetiredStreams();
+}
+
+void APlanetActor::RequestGeneration()
+{
+	// The scheduler only exists in game worlds; the editor keeps generating synchronously
+	UWorld* World = GetWorld();
+	UPlanetSubsystem* Subsystem = World ? World->GetSubsystem<UPlanetSubsystem>() : nullptr;
+	if (Subsystem && GetDefault<UPlanetGeneratorSettings>()->bUseGenerationScheduler)
+	{
+		bGenerationDirty = true;
+		Subsystem->RequestGeneration(this);
+		return;
+	}
+
+	GeneratePlanet();
+}
+
+FPlanetBuildSettings APlanetActor::MakeBuildSettings() const
+{
+	FPlanetBuildSettings Settings;
+	Settings.PlanetRadius = PlanetRadius;
+	Settings.Resolution = GetEffectiveResolution();
+	Settings.Seed = Seed;
+	Settings.NoiseLayers = NoiseLayers;
+	Settings.Biomes = Biomes;
+	Settings.EquatorTemperature = EquatorTemperature;
+	Settings.PoleTemperature = PoleTemperature;
+	Settings.MoistureScale = MoistureScale;
+	Settings.ColorMode = ColorMode;
+	if (ColorMode == EPlanetColorMode::BiomePalette && !SurfaceMaterialHasTexture(FName("BiomePalette")))
+	{
+		// Palette indices would show as colours without a material that looks them up
+		UE_LOG(LogTemp, Warning, TEXT("%s: the planet material has no BiomePalette parameter, baking vertex colors instead"), *GetName());
+		Settings.ColorMode = EPlanetColorMode::BakedColors;
+	}
+	Settings.HasOcean = HasOcean;
+	Settings.OceanLevel = OceanLevel;
+	Settings.OceanResolution = OceanResolution;
+	Settings.CollisionMode = CollisionMode;
+	Settings.CollisionResolution = CollisionResolution;
+	Settings.BakeSurfaceTextures = BakeSurfaceTextures && BakeFaceResolution > 0;
+	if (Settings.BakeSurfaceTextures && !SurfaceMaterialHasTexture(FName("PlanetAlbedo")))
+	{
+		// Nothing would sample the atlases, so the bake is not worth its time and memory
+		UE_LOG(LogTemp, Warning, TEXT("%s: the planet material has no PlanetAlbedo parameter, skipping the surface bake"), *GetName());
+		Settings.BakeSurfaceTextures = false;
+	}
+	Settings.BakeFaceResolution = BakeFaceResolution;
+	// No atlas is baked when there is no material to draw it with
+	Settings.ImpostorResolution = UseImpostor && GetImpostorMaterial() ? FMath::Max(ImpostorResolution, 0) : 0;
+	Settings.ImpostorOceanColor = ImpostorOceanColor;
+	Settings.bComputeOutputHash = VerifyGeneration;
+	Settings.bOptimizeMeshOrder = OptimizeMeshOrder;
+	Settings.bBuildRenderStreams = UsePlanetMeshComponent;
+
+	// Octaves follow the calibrated preset like the resolution does
+	const UWorld* World = GetWorld();
+	if (World && World->IsGameWorld() && UPlanetCalibration::IsActive())
+	{
+		const int32 MaxOctaves = GetDefault<UPlanetCalibration>()->MaxOctaves;
+		for (FNoiseLayer& Layer : Settings.NoiseLayers)
+		{
+			Layer.NumLayers = FMath::Min(Layer.NumLayers, MaxOctaves);
 		}
 	}
+
+	return Settings;
 }
 
-void APlanetActor::GeneratePlanet()
+FPlanetBuildSettings APlanetActor::BeginGeneration()
+{
+	// Changes made after the snapshot mark the planet dirty again and trigger another build
+	bGenerationDirty = false;
+	return MakeBuildSettings();
+}
+
+void APlanetActor::ApplyBuildResult(FPlanetBuildResult&& Result)
 {
-	ClearMesh();
-	CreateIcosphere();
-	SubdivideIcosphere(Resolution);
+	check(IsInGameThread());
+
+	FPlanetGenerationStats& Stats = Result.Stats;
+	{
+		PLANET_STAGE_SCOPE(Apply, Stats.ApplyMs);
+
+		// The structures being replaced go back with the result, which rebuilds them in place next time
+		TSharedPtr<const FPlanetTileGraph> OldTileGraph = MoveTemp(TileGraph);
+		TSharedPtr<const FPlanetSpatialIndex> OldSpatialIndex = MoveTemp(SpatialIndex);
+		TSharedPtr<const FPlanetTileAttributes> OldAttributes = MoveTemp(Attributes);
+		TSharedPtr<const FPlanetPathfinder> OldPathfinder = MoveTemp(Pathfinder);
+		TSharedPtr<const FPlanetSurfaceSampler> OldSurfaceSampler = MoveTemp(SurfaceSampler);
+
+		ClearMesh();
+
+		// Swapped rather than moved, so the result leaves with our old buffers for the next build
+		Swap(Vertices, Result.UnitVertices);
+		Swap(Triangles, Result.Triangles);
+		Swap(TriangleNeighbours, Result.TriangleNeighbours);
+		Swap(RenderTriangles, Result.RenderTriangles);
+		Swap(Normals, Result.Normals);
+		Swap(UV0, Result.UV0);
+		Swap(VertexColors, Result.VertexColors);
+		Swap(Tangents, Result.Tangents);
+
+		TileGraph = MoveTemp(Result.TileGraph);
+		SpatialIndex = MoveTemp(Result.SpatialIndex);
+		Attributes = MoveTemp(Result.Attributes);
+		Pathfinder = MoveTemp(Result.Pathfinder);
+		SurfaceSampler = MoveTemp(Result.SurfaceSampler);
+		Result.TileGraph = MoveTemp(OldTileGraph);
+		Result.SpatialIndex = MoveTemp(OldSpatialIndex);
+		Result.Attributes = MoveTemp(OldAttributes);
+		Result.Pathfinder = MoveTemp(OldPathfinder);
+		Result.SurfaceSampler = MoveTemp(OldSurfaceSampler);
+
+		// Kept so palette edits resolve slots against the table the mesh was generated with
+		BiomeLookup = MoveTemp(Result.BiomeLookup);
+		bMeshUsesBiomePalette = Result.bUsesBiomePalette;
+
+		// Store the final vertices for later use
+		Swap(CachedVertices, Result.Positions);
 
-	// Calculate normals, UVs, and colors
-	Normals.SetNum(Vertices.Num());
-	UV0.SetNum(Vertices.Num());
-	VertexColors.SetNum(Vertices.Num());
+		{
+			PLANET_STAGE_SCOPE(Upload, Stats.UploadMs);
 
-	// Calculate final positions with noise and biomes
-	TArray<FVector> FinalVertices;
-	FinalVertices.SetNum(Vertices.Num());
+			if (UsePlanetMeshComponent && Result.RenderStreams.Num() == CachedVertices.Num())
+			{
+				// The streams move into the component; no section copy and no render-side repacking
+				TSharedRef<FPlanetIndexBuffer, ESPMode::ThreadSafe> IndexBuffer = UPlanetMeshComponent::FindOrCreateIndexBuffer(GetRenderTriangles(), Result.IndexBufferKey);
+				PlanetSurface->SetMesh(MoveTemp(Result.RenderStreams), IndexBuffer, UsesRenderMeshCollision());
+			}
+			else
+			{
+				// Create the procedural mesh with correct winding order
+				PlanetMesh->CreateMeshSection_LinearColor(0, CachedVertices, GetRenderTriangles(), Normals, UV0, VertexColors, Tangents, UsesRenderMeshCollision());
+			}
+
+			// Upload the ocean shell that the build culled against
+			BuildOcean(Result.OceanShell);
+		}
+
+		// Apply material
+		if (bMeshUsesBiomePalette)
+		{
+			ApplyBiomePalette();
+		}
+		else if (SurfaceMaterialInstance)
+		{
+			SurfaceMaterialInstance->SetScalarParameterValue(FName("UseBiomePalette"), 0.0f);
+		}
 
-	for (int32 i = 0; i < Vertices.Num(); i++)
+		if (Result.SurfaceBake.IsValid())
+		{
+			SurfaceBake = MoveTemp(Result.SurfaceBake);
+			UploadSurfaceBake();
+		}
+		else if (SurfaceBake.IsValid())
+		{
+			// Drop a stale bake so the material goes back to vertex detail
+			SurfaceBake.Reset();
+			BakedAlbedoTexture = nullptr;
+			BakedHeightTexture = nullptr;
+			BakedNormalTexture = nullptr;
+			ApplySurfaceBake();
+		}
+
+		if (UMaterialInterface* SurfaceMaterial = GetSurfaceMaterial())
+		{
+			GetSurfaceComponent()->SetMaterial(0, SurfaceMaterial);
+		}
+
+		// Debug: Show normals
+		if (ShowNormals)
+		{
+			for (int32 i = 0; i < CachedVertices.Num(); i++)
+			{
+				DrawDebugLine(GetWorld(), CachedVertices[i], CachedVertices[i] + Normals[i] * NormalLength, FColor::Red, true, -1.0f, 0, 1.0f);
+			}
+		}
+
+		{
+			PLANET_STAGE_SCOPE(CollisionSetup, Stats.CollisionSetupMs);
+
+			// Collision is built separately from the render mesh and only cooked in the mesh modes
+			BuildCollision(Result);
+		}
+
+		ApplyImpostor(Result.Impostor);
+	}
+
+	LastGenerationStats = Stats;
+	GenerationHash = Result.OutputHash;
+	if (VerifyGeneration)
 	{
-		FVector PointOnUnitSphere = Vertices[i].GetSafeNormal();
-		FVector PointOnPlanet = CalculatePointOnPlanet(PointOnUnitSphere);
-		FinalVertices[i] = PointOnPlanet;
+		UE_LOG(LogTemp, Display, TEXT("Planet %s generated with seed %d, hash %s"), *GetName(), Seed, *GenerationHash);
+	}
+	SET_DWORD_STAT(STAT_PlanetVertices, Stats.NumVertices);
+	SET_DWORD_STAT(STAT_PlanetTriangles, Stats.NumTriangles);
 
-		// Calculate normal - FIXED: Ensure normals point outward from the center
-		// For a planet, normals should point away from the center
-		Normals[i] = (PointOnPlanet - GetActorLocation()).GetSafeNormal();
+	UE_LOG(LogTemp, Log, TEXT("Planet generated with %d vertices and %d triangles: build %.2f ms (subdivision %.2f, topology %.2f, noise %.2f, climate %.2f, biomes %.2f, tangents %.2f, ocean %.2f, bake %.2f, collision %.2f), apply %.2f ms (upload %.2f, collision setup %.2f), %.1f KB"),
+		Stats.NumVertices, Stats.NumTriangles, Stats.BuildMs, Stats.SubdivisionMs, Stats.TopologyMs, Stats.NoiseMs, Stats.ClimateMs, Stats.BiomeMs,
+		Stats.TangentsMs, Stats.OceanMs, Stats.BakeMs, Stats.CollisionMs, Stats.ApplyMs, Stats.UploadMs, Stats.CollisionSetupMs, Stats.BytesAllocated / 1024.0);
 
-		// Calculate UV (simple spherical mapping)
-		float U = 0.5f + FMath::Atan2(PointOnUnitSphere.Y, PointOnUnitSphere.X) / (2.0f * PI);
-		float V = 0.5f - FMath::Asin(PointOnUnitSphere.Z) / PI;
-		UV0[i] = FVector2D(U, V);
+	// Log collision settings
+	UE_LOG(LogTemp, Log, TEXT("Planet collision enabled: %s"),
+		PlanetMesh->IsCollisionEnabled() ? TEXT("Yes") : TEXT("No"));
+	UE_LOG(LogTemp, Log, TEXT("Planet collision profile: %s"),
+		*PlanetMesh->GetCollisionProfileName().ToString());
 
-		// Calculate biome color
-		float Height = (PointOnPlanet.Size() - PlanetRadius) / (PlanetRadius * 0.2f);
-		Height = FMath::Clamp(Height, 0.0f, 1.0f);
+	OnPlanetGenerated.Broadcast(this, LastGenerationStats);
+}
 
-		float Temperature = GetTemperature(PointOnUnitSphere);
-		float Moisture = GetMoisture(PointOnUnitSphere);
+void APlanetActor::ApplyImpostor(const FPlanetImpostorAtlas& Atlas)
+{
+	UMaterialInterface* BaseMaterial = Atlas.IsValid() ? GetImpostorMaterial() : nullptr;
+	if (!BaseMaterial)
+	{
+		// Without a material the billboard would draw nothing, so the meshes stay up
+		ImpostorTexture = nullptr;
+		ImpostorMaterialInstance = nullptr;
+		ImpostorBillboard->SetElements(TArray<FMaterialSpriteElement>());
+		SetImpostorVisible(false);
+	}
+	else
+	{
+		ImpostorTexture = UPlanetMaterialGenerator::CreateDataTexture(Atlas.Resolution, Atlas.Resolution, PF_B8G8R8A8, Atlas.Albedo.GetData(), sizeof(FColor), true);
+
+		if (!ImpostorMaterialInstance || ImpostorMaterialInstance->Parent != BaseMaterial)
+		{
+			ImpostorMaterialInstance = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+		}
+
+		ImpostorMaterialInstance->SetTextureParameterValue(FName("ImpostorAtlas"), ImpostorTexture);
+		ImpostorMaterialInstance->SetScalarParameterValue(FName("ImpostorResolution"), (float)Atlas.Resolution);
 
-		EBiomeType BiomeType = DetermineBiome(Height, Temperature, Moisture);
-		VertexColors[i] = GetBiomeColor(BiomeType, Height, Temperature, Moisture);
+		// The quad spans the silhouette, including the sea and the highest peaks
+		const float Diameter = 2.0f * PlanetRadius * 1.2f;
+
+		FMaterialSpriteElement Sprite;
+		Sprite.Material = ImpostorMaterialInstance;
+		Sprite.bSizeIsInScreenSpace = false;
+		Sprite.BaseSizeX = Diameter;
+		Sprite.BaseSizeY = Diameter;
+		ImpostorBillboard->SetElements({ Sprite });
 	}
 
-	// Create tangents
-	Tangents.SetNum(Vertices.Num());
-	for (int32 i = 0; i < Vertices.Num(); i++)
+	// The world subsystem swaps between the meshes and the impostor by screen size
+	if (UWorld* World = GetWorld())
 	{
-		FVector Normal = Normals[i];
-		FVector Tangent = FVector::CrossProduct(Normal, FVector::UpVector);
-		if (Tangent.SizeSquared() < SMALL_NUMBER)
+		if (UPlanetSubsystem* Subsystem = World->GetSubsystem<UPlanetSubsystem>())
 		{
-			Tangent = FVector::CrossProduct(Normal, FVector::ForwardVector);
+			Subsystem->UpdateImpostor(this);
 		}
-		Tangent.Normalize();
-		Tangents[i] = FProcMeshTangent(Tangent, false);
+	}
+}
+
+UMaterialInterface* APlanetActor::GetImpostorMaterial() const
+{
+	if (ImpostorMaterial)
+	{
+		return ImpostorMaterial;
+	}
+
+	// The plugin does not ship a default impostor material; a project can provide one at this path
+	static const FSoftObjectPath DefaultPath(TEXT("/PlanetGenerator/Materials/M_PlanetImpostor.M_PlanetImpostor"));
+	UMaterialInterface* DefaultMaterial = Cast<UMaterialInterface>(DefaultPath.TryLoad());
+	if (!DefaultMaterial)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: no ImpostorMaterial set and M_PlanetImpostor not found. The planet impostor is disabled."), *GetName());
+	}
+	return DefaultMaterial;
+}
+
+void APlanetActor::SetImpostorVisible(bool bVisible)
+{
+	bVisible = bVisible && HasImpostor();
+	if (bShowingImpostor == bVisible)
+	{
+		return;
 	}
 
-	// Create the procedural mesh with correct winding order
-	PlanetMesh->CreateMeshSection_LinearColor(0, FinalVertices, Triangles, Normals, UV0, VertexColors, Tangents, true);
+	bShowingImpostor = bVisible;
 
-	// Store the triangles for later use
-	StoredTriangles = Triangles;
+	// Hidden components submit no draws; collision and traces are unaffected
+	PlanetMesh->SetVisibility(!bVisible);
+	PlanetSurface->SetVisibility(!bVisible);
+	OceanMesh->SetVisibility(!bVisible);
+	ImpostorBillboard->SetHiddenInGame(!bVisible);
+	ImpostorBillboard->SetVisibility(bVisible);
+}
 
-	// Apply material
-	if (PlanetMaterial)
+int32 APlanetActor::GetTargetResolution() const
+{
+	const UWorld* World = GetWorld();
+	if (World && World->IsGameWorld() && UPlanetCalibration::IsActive())
 	{
-		PlanetMesh->SetMaterial(0, PlanetMaterial);
+		return FMath::Min(Resolution, GetDefault<UPlanetCalibration>()->MaxResolution);
 	}
+	return Resolution;
+}
+
+int32 APlanetActor::GetEffectiveResolution() const
+{
+	const int32 TargetResolution = GetTargetResolution();
+	return GovernedResolution == INDEX_NONE ? TargetResolution : FMath::Min(TargetResolution, GovernedResolution);
+}
 
-	// Debug: Show normals
-	if (ShowNormals)
+int64 APlanetActor::GetGeometryMemorySize() const
+{
+	SIZE_T Size = Vertices.GetAllocatedSize() + Triangles.GetAllocatedSize() + Normals.GetAllocatedSize()
+		+ UV0.GetAllocatedSize() + VertexColors.GetAllocatedSize() + Tangents.GetAllocatedSize()
+		+ CachedVertices.GetAllocatedSize() + RenderTriangles.GetAllocatedSize()
+		+ TriangleNeighbours.GetAllocatedSize() + OriginalVertexColors.GetAllocatedSize()
+		+ SurfaceBake.Heights.GetAllocatedSize() + SurfaceBake.Albedo.GetAllocatedSize() + SurfaceBake.Normals.GetAllocatedSize();
+
+	// Query structures; each counts only what it holds itself
+	if (TileGraph.IsValid())
+	{
+		Size += TileGraph->GetAllocatedSize();
+	}
+	if (Attributes.IsValid())
 	{
-		for (int32 i = 0; i < FinalVertices.Num(); i++)
+		Size += Attributes->GetAllocatedSize();
+	}
+	if (SpatialIndex.IsValid())
+	{
+		Size += SpatialIndex->GetAllocatedSize();
+	}
+	if (SurfaceSampler.IsValid())
+	{
+		Size += SurfaceSampler->GetAllocatedSize();
+	}
+	if (Pathfinder.IsValid())
+	{
+		Size += Pathfinder->GetAllocatedSize();
+	}
+
+	// The planet mesh component shares its streams with its scene proxy
+	Size += PlanetSurface->GetMeshAllocatedSize();
+
+	// Buffers kept at full capacity for the next regeneration
+	Size += GetRecycledMemorySize();
+
+	// The procedural mesh keeps its own copy of every section
+	for (UProceduralMeshComponent* Mesh : { PlanetMesh, OceanMesh })
+	{
+		for (int32 Section = 0; Mesh && Section < Mesh->GetNumSections(); Section++)
 		{
-			DrawDebugLine(GetWorld(), FinalVertices[i], FinalVertices[i] + Normals[i] * NormalLength, FColor::Red, true, -1.0f, 0, 1.0f);
+			const FProcMeshSection* MeshSection = Mesh->GetProcMeshSection(Section);
+			if (MeshSection)
+			{
+				Size += MeshSection->ProcVertexBuffer.GetAllocatedSize() + MeshSection->ProcIndexBuffer.GetAllocatedSize();
+			}
 		}
 	}
 
-	// Store the final vertices for later use
-	CachedVertices = FinalVertices;
+	return (int64)Size;
+}
 
-	// Make sure collision is enabled
-	PlanetMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-	PlanetMesh->SetCollisionResponseToAllChannels(ECR_Block);
-	PlanetMesh->SetGenerateOverlapEvents(true);
+void APlanetActor::SetMemoryGovernorState(int32 ResolutionCap, bool bForceImpostor)
+{
+	GovernedResolution = ResolutionCap;
+	GovernorForcesImpostor = bForceImpostor && HasImpostor();
 
-	// Add this after the collision setup
-	PlanetMesh->bUseComplexAsSimpleCollision = true;
+	// Lifting a cap regenerates too, so the planet returns to its own Resolution
+	if (LastGenerationStats.Resolution != INDEX_NONE && GetEffectiveResolution() != LastGenerationStats.Resolution)
+	{
+		MarkGenerationDirty();
+	}
+}
 
-	// Log collision settings
-	UE_LOG(LogTemp, Log, TEXT("Planet generated with %d vertices and %d triangles"), Vertices.Num(), Triangles.Num() / 3);
-	UE_LOG(LogTemp, Log, TEXT("Planet collision enabled: %s"),
-		PlanetMesh->IsCollisionEnabled() ? TEXT("Yes") : TEXT("No"));
-	UE_LOG(LogTemp, Log, TEXT("Planet collision profile: %s"),
-		*PlanetMesh->GetCollisionProfileName().ToString());
+void APlanetActor::ApplyGenerationParams(const FPlanetGenerationParams& Params)
+{
+	PlanetRadius = Params.PlanetRadius;
+	Resolution = Params.Resolution;
+	Seed = Params.Seed;
+
+	if (Params.NoiseLayers.Num() > 0)
+	{
+		NoiseLayers = Params.NoiseLayers;
+	}
+
+	if (Params.Biomes.Num() > 0)
+	{
+		Biomes = Params.Biomes;
+	}
+
+	EquatorTemperature = Params.EquatorTemperature;
+	PoleTemperature = Params.PoleTemperature;
+	MoistureScale = Params.MoistureScale;
+
+	if (Params.PlanetMaterial)
+	{
+		PlanetMaterial = Params.PlanetMaterial;
+	}
+	ColorMode = Params.ColorMode;
+
+	HasOcean = Params.HasOcean;
+	OceanLevel = Params.OceanLevel;
+	if (Params.OceanMaterial)
+	{
+		OceanMaterial = Params.OceanMaterial;
+	}
+
+	CollisionMode = Params.CollisionMode;
+	CollisionResolution = Params.CollisionResolution;
 }
 
-void APlanetActor::ClearMesh()
+void APlanetActor::MarkGenerationDirty()
 {
-	// Store triangles before clearing
-	if (Triangles.Num() > 0)
+	if (bGenerationDirty)
+	{
+		return;
+	}
+
+	bGenerationDirty = true;
+
+	// Outside a running world there is no next tick, so the caller regenerates explicitly
+	UWorld* World = GetWorld();
+	if (World && World->IsGameWorld())
 	{
-		StoredTriangles = Triangles;
+		UPlanetSubsystem* Subsystem = World->GetSubsystem<UPlanetSubsystem>();
+		if (Subsystem && GetDefault<UPlanetGeneratorSettings>()->bUseGenerationScheduler)
+		{
+			// The settings snapshot is taken when the build starts, so further edits this frame join it
+			Subsystem->RequestGeneration(this);
+		}
+		else
+		{
+			World->GetTimerManager().SetTimerForNextTick(this, &APlanetActor::RegenerateIfDirty);
+		}
 	}
+}
 
-	Vertices.Empty();
-	Triangles.Empty();
-	Normals.Empty();
-	UV0.Empty();
-	VertexColors.Empty();
-	Tangents.Empty();
-	CachedVertices.Empty();
+void APlanetActor::RegenerateIfDirty()
+{
+	if (bGenerationDirty)
+	{
+		GeneratePlanet();
+	}
+}
+
+void APlanetActor::ClearMesh()
+{
+	// Reset keeps capacity; the next generation swaps its buffers in and recycles these
+	Vertices.Reset();
+	Triangles.Reset();
+	Normals.Reset();
+	UV0.Reset();
+	VertexColors.Reset();
+	Tangents.Reset();
+	CachedVertices.Reset();
+	TriangleNeighbours.Reset();
+	RenderTriangles.Reset();
+	TileGraph.Reset();
+	Attributes.Reset();
+	Pathfinder.Reset();
+	SpatialIndex.Reset();
+	SurfaceSampler.Reset();
 
 	PlanetMesh->ClearAllMeshSections();
+	PlanetSurface->ClearMesh();
 }
 
-void APlanetActor::CreateIcosphere()
+int32 APlanetActor::GetTileCount() const
 {
-	// Create an icosahedron (20-sided polyhedron)
-	const float t = (1.0f + FMath::Sqrt(5.0f)) / 2.0f;
+	return TileGraph.IsValid() ? TileGraph->GetNumTiles() : 0;
+}
 
-	// Add vertices
-	Vertices.Add(FVector(-1, t, 0).GetSafeNormal());
-	Vertices.Add(FVector(1, t, 0).GetSafeNormal());
-	Vertices.Add(FVector(-1, -t, 0).GetSafeNormal());
-	Vertices.Add(FVector(1, -t, 0).GetSafeNormal());
+TArray<int32> APlanetActor::GetTileNeighbours(int32 TileIndex) const
+{
+	if (!TileGraph.IsValid())
+	{
+		return TArray<int32>();
+	}
 
-	Vertices.Add(FVector(0, -1, t).GetSafeNormal());
-	Vertices.Add(FVector(0, 1, t).GetSafeNormal());
-	Vertices.Add(FVector(0, -1, -t).GetSafeNormal());
-	Vertices.Add(FVector(0, 1, -t).GetSafeNormal());
+	return TArray<int32>(TileGraph->GetTileNeighbours(TileIndex));
+}
 
-	Vertices.Add(FVector(t, 0, -1).GetSafeNormal());
-	Vertices.Add(FVector(t, 0, 1).GetSafeNormal());
-	Vertices.Add(FVector(-t, 0, -1).GetSafeNormal());
-	Vertices.Add(FVector(-t, 0, 1).GetSafeNormal());
+TArray<int32> APlanetActor::GetVertexNeighbours(int32 VertexIndex) const
+{
+	if (!TileGraph.IsValid())
+	{
+		return TArray<int32>();
+	}
 
-	// FIXED: Ensure consistent winding order for all triangles (clockwise)
-	// 5 faces around point 0
-	Triangles.Add(0); Triangles.Add(5); Triangles.Add(11);
-	Triangles.Add(0); Triangles.Add(1); Triangles.Add(5);
-	Triangles.Add(0); Triangles.Add(7); Triangles.Add(1);
-	Triangles.Add(0); Triangles.Add(10); Triangles.Add(7);
-	Triangles.Add(0); Triangles.Add(11); Triangles.Add(10);
+	return TArray<int32>(TileGraph->GetVertexNeighbours(VertexIndex));
+}
 
-	// 5 adjacent faces
-	Triangles.Add(1); Triangles.Add(9); Triangles.Add(5);
-	Triangles.Add(5); Triangles.Add(4); Triangles.Add(11);
-	Triangles.Add(11); Triangles.Add(2); Triangles.Add(10);
-	Triangles.Add(10); Triangles.Add(6); Triangles.Add(7);
-	Triangles.Add(7); Triangles.Add(8); Triangles.Add(1);
+TArray<int32> APlanetActor::GetTileRing(int32 TileIndex, int32 Distance) const
+{
+	TArray<int32> Ring;
+	if (TileGraph.IsValid())
+	{
+		TileGraph->GetTileRing(TileIndex, Distance, Ring);
+	}
 
-	// 5 faces around point 3
-	Triangles.Add(3); Triangles.Add(4); Triangles.Add(9);
-	Triangles.Add(3); Triangles.Add(2); Triangles.Add(4);
-	Triangles.Add(3); Triangles.Add(6); Triangles.Add(2);
-	Triangles.Add(3); Triangles.Add(8); Triangles.Add(6);
-	Triangles.Add(3); Triangles.Add(9); Triangles.Add(8);
+	return Ring;
+}
+
+float APlanetActor::GetTileHeight(int32 TileIndex) const
+{
+	return Attributes.IsValid() && Attributes->IsValidTile(TileIndex) ? Attributes->TileHeights[TileIndex] : 0.0f;
+}
+
+float APlanetActor::GetTileTemperature(int32 TileIndex) const
+{
+	return Attributes.IsValid() && Attributes->IsValidTile(TileIndex) ? Attributes->TileTemperatures[TileIndex] : 0.0f;
+}
 
-	// 5 adjacent faces
-	Triangles.Add(4); Triangles.Add(5); Triangles.Add(9);
-	Triangles.Add(2); Triangles.Add(11); Triangles.Add(4);
-	Triangles.Add(6); Triangles.Add(10); Triangles.Add(2);
-	Triangles.Add(8); Triangles.Add(7); Triangles.Add(6);
-	Triangles.Add(9); Triangles.Add(1); Triangles.Add(8);
+float APlanetActor::GetTileMoisture(int32 TileIndex) const
+{
+	return Attributes.IsValid() && Attributes->IsValidTile(TileIndex) ? Attributes->TileMoistures[TileIndex] : 0.0f;
+}
 
-	UE_LOG(LogTemp, Log, TEXT("Icosphere created with %d vertices and %d triangles"), Vertices.Num(), Triangles.Num() / 3);
+EBiomeType APlanetActor::GetTileBiome(int32 TileIndex) const
+{
+	return Attributes.IsValid() && Attributes->IsValidTile(TileIndex) ? (EBiomeType)Attributes->TileBiomes[TileIndex] : EBiomeType::Plains;
 }
 
-void APlanetActor::SubdivideIcosphere(int32 Subdivisions)
+EBiomeType APlanetActor::GetVertexBiome(int32 VertexIndex) const
 {
-	if (Subdivisions <= 0)
+	return Attributes.IsValid() && Attributes->IsValidVertex(VertexIndex) ? (EBiomeType)Attributes->VertexBiomes[VertexIndex] : EBiomeType::Plains;
+}
+
+void APlanetActor::GetAllTileAttributes(TArray<float>& OutHeights, TArray<float>& OutTemperatures, TArray<float>& OutMoistures, TArray<EBiomeType>& OutBiomes) const
+{
+	if (!Attributes.IsValid())
 	{
+		OutHeights.Reset();
+		OutTemperatures.Reset();
+		OutMoistures.Reset();
+		OutBiomes.Reset();
 		return;
 	}
 
-	TMap<FVector2D, int32> MiddlePointIndexCache;
+	OutHeights = Attributes->TileHeights;
+	OutTemperatures = Attributes->TileTemperatures;
+	OutMoistures = Attributes->TileMoistures;
 
-	for (int32 i = 0; i < Subdivisions; i++)
+	// EBiomeType is a uint8 enum, so the biome bytes copy straight across
+	OutBiomes.SetNumUninitialized(Attributes->TileBiomes.Num());
+	FMemory::Memcpy(OutBiomes.GetData(), Attributes->TileBiomes.GetData(), Attributes->TileBiomes.Num());
+}
+
+void APlanetActor::GetTileAttributesForTiles(const TArray<int32>& TileIndices, TArray<float>& OutHeights, TArray<float>& OutTemperatures, TArray<float>& OutMoistures, TArray<EBiomeType>& OutBiomes) const
+{
+	OutHeights.Reset(TileIndices.Num());
+	OutTemperatures.Reset(TileIndices.Num());
+	OutMoistures.Reset(TileIndices.Num());
+	OutBiomes.Reset(TileIndices.Num());
+
+	for (int32 TileIndex : TileIndices)
 	{
-		TArray<int32> NewTriangles;
+		OutHeights.Add(GetTileHeight(TileIndex));
+		OutTemperatures.Add(GetTileTemperature(TileIndex));
+		OutMoistures.Add(GetTileMoisture(TileIndex));
+		OutBiomes.Add(GetTileBiome(TileIndex));
+	}
+}
 
-		// Subdivide each triangle into 4 triangles
-		for (int32 j = 0; j < Triangles.Num(); j += 3)
-		{
-			int32 v1 = Triangles[j];
-			int32 v2 = Triangles[j + 1];
-			int32 v3 = Triangles[j + 2];
+bool APlanetActor::SampleSurface(const TArray<FVector>& Directions, TArray<FVector>& OutLocations, TArray<FVector>& OutNormals, TArray<EBiomeType>& OutBiomes, bool bWorldSpace) const
+{
+	OutLocations.Reset();
+	OutNormals.Reset();
+	OutBiomes.Reset();
 
-			// Get or create mid points
-			int32 a = GetMiddlePoint(v1, v2, MiddlePointIndexCache);
-			int32 b = GetMiddlePoint(v2, v3, MiddlePointIndexCache);
-			int32 c = GetMiddlePoint(v3, v1, MiddlePointIndexCache);
+	if (!SurfaceSampler.IsValid() || !SurfaceSampler->IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SampleSurface: Planet has not been generated"));
+		return false;
+	}
 
-			// Create 4 new triangles
-			NewTriangles.Add(v1); NewTriangles.Add(a); NewTriangles.Add(c);
-			NewTriangles.Add(v2); NewTriangles.Add(b); NewTriangles.Add(a);
-			NewTriangles.Add(v3); NewTriangles.Add(c); NewTriangles.Add(b);
-			NewTriangles.Add(a); NewTriangles.Add(b); NewTriangles.Add(c);
-		}
+	TArray<FPlanetSurfaceSample> Samples;
+	Samples.SetNum(Directions.Num());
+	SurfaceSampler->SampleBatch(Directions, Samples);
+
+	const FTransform& Transform = GetActorTransform();
+	OutLocations.SetNumUninitialized(Samples.Num());
+	OutNormals.SetNumUninitialized(Samples.Num());
+	OutBiomes.SetNumUninitialized(Samples.Num());
+
+	for (int32 i = 0; i < Samples.Num(); i++)
+	{
+		OutLocations[i] = bWorldSpace ? Transform.TransformPosition(Samples[i].Position) : Samples[i].Position;
+		OutNormals[i] = bWorldSpace ? Transform.TransformVectorNoScale(Samples[i].Normal) : Samples[i].Normal;
+		OutBiomes[i] = (EBiomeType)Samples[i].Biome;
+	}
 
-		Triangles = NewTriangles;
+	return true;
+}
+
+int32 APlanetActor::FindTileAtLocation(FVector WorldLocation) const
+{
+	if (!SpatialIndex.IsValid())
+	{
+		return -1;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("Subdivided icosphere to %d vertices and %d triangles"), Vertices.Num(), Triangles.Num() / 3);
+	FVector LocalDirection = GetActorTransform().InverseTransformPosition(WorldLocation);
+	return SpatialIndex->FindNearestTile(LocalDirection);
 }
 
-int32 APlanetActor::GetMiddlePoint(int32 p1, int32 p2, TMap<FVector2D, int32>& Cache)
+TArray<int32> APlanetActor::GetTilesInRadius(FVector WorldLocation, float Radius) const
 {
-	// First check if we already have it
-	bool FirstIsSmaller = p1 < p2;
-	int64 SmallerIndex = FirstIsSmaller ? p1 : p2;
-	int64 GreaterIndex = FirstIsSmaller ? p2 : p1;
-	FVector2D Key(SmallerIndex, GreaterIndex);
+	TArray<int32> Tiles;
+	if (SpatialIndex.IsValid() && PlanetRadius > 0.0f)
+	{
+		FVector LocalDirection = GetActorTransform().InverseTransformPosition(WorldLocation);
+		SpatialIndex->GetTilesInCap(LocalDirection, Radius / PlanetRadius, Tiles);
+	}
 
-	int32* CachedIndex = Cache.Find(Key);
-	if (CachedIndex)
+	return Tiles;
+}
+
+TArray<int32> APlanetActor::FloodFillBiome(int32 SeedTile) const
+{
+	TArray<int32> Tiles;
+	if (TileGraph.IsValid() && Attributes.IsValid() && Attributes->IsValidTile(SeedTile))
 	{
-		return *CachedIndex;
+		const TArray<uint8>& TileBiomes = Attributes->TileBiomes;
+		const uint8 SeedBiome = TileBiomes[SeedTile];
+		TileGraph->FloodFill(SeedTile, [&TileBiomes, SeedBiome](int32 Tile) { return TileBiomes[Tile] == SeedBiome; }, Tiles);
 	}
 
-	// Not in cache, calculate it
-	FVector Point1 = Vertices[p1];
-	FVector Point2 = Vertices[p2];
-	FVector Middle = (Point1 + Point2) * 0.5f;
+	return Tiles;
+}
 
-	// Add vertex makes sure point is on unit sphere
-	int32 Index = Vertices.Add(Middle.GetSafeNormal());
+TArray<int32> APlanetActor::FloodFillElevation(int32 SeedTile, float MinHeight, float MaxHeight) const
+{
+	TArray<int32> Tiles;
+	if (TileGraph.IsValid() && Attributes.IsValid())
+	{
+		const TArray<float>& TileHeights = Attributes->TileHeights;
+		TileGraph->FloodFill(SeedTile, [&TileHeights, MinHeight, MaxHeight](int32 Tile)
+		{
+			return TileHeights[Tile] >= MinHeight && TileHeights[Tile] <= MaxHeight;
+		}, Tiles);
+	}
 
-	// Add to cache
-	Cache.Add(Key, Index);
+	return Tiles;
+}
+
+int32 APlanetActor::LabelBiomeRegions(TArray<int32>& OutLabels) const
+{
+	OutLabels.Reset();
+	if (!TileGraph.IsValid() || !Attributes.IsValid())
+	{
+		return 0;
+	}
+
+	const TArray<uint8>& TileBiomes = Attributes->TileBiomes;
+	return TileGraph->LabelComponents([&TileBiomes](int32 TileA, int32 TileB) { return TileBiomes[TileA] == TileBiomes[TileB]; }, OutLabels);
+}
+
+int32 APlanetActor::LabelElevationRegions(float Threshold, TArray<int32>& OutLabels) const
+{
+	OutLabels.Reset();
+	if (!TileGraph.IsValid() || !Attributes.IsValid())
+	{
+		return 0;
+	}
+
+	const TArray<float>& TileHeights = Attributes->TileHeights;
+	return TileGraph->LabelComponents([&TileHeights, Threshold](int32 TileA, int32 TileB)
+	{
+		return (TileHeights[TileA] >= Threshold) == (TileHeights[TileB] >= Threshold);
+	}, OutLabels);
+}
+
+FPlanetPathCosts APlanetActor::MakePathCosts() const
+{
+	FPlanetPathCosts Costs;
+	for (const TPair<EBiomeType, float>& Pair : BiomeMovementCosts)
+	{
+		Costs.BiomeCosts[(uint8)Pair.Key] = Pair.Value;
+	}
+	Costs.ElevationCostScale = ElevationCostScale;
+
+	return Costs;
+}
+
+bool APlanetActor::FindTilePath(int32 StartTile, int32 GoalTile, TArray<int32>& OutPath, float& OutCost) const
+{
+	OutPath.Reset();
+	OutCost = 0.0f;
+
+	if (!Pathfinder.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FindTilePath: Planet has not been generated"));
+		return false;
+	}
+
+	FPlanetPathResult Result;
+	if (!Pathfinder->FindPath(StartTile, GoalTile, MakePathCosts(), Result))
+	{
+		return false;
+	}
 
-	return Index;
+	OutPath = MoveTemp(Result.Tiles);
+	OutCost = Result.Cost;
+	return true;
 }
 
-float APlanetActor::EvaluateNoise(const FVector& PointOnUnitSphere)
+void APlanetActor::FindTilePathsAsync(const TArray<FPlanetPathQuery>& Queries, FOnPlanetPathsFound OnComplete)
 {
-	float FirstLayerValue = 0;
-	float Elevation = 0;
-	float Weight = 1;
+	if (!Pathfinder.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FindTilePathsAsync: Planet has not been generated"));
+
+		TArray<FPlanetPathResult> Results;
+		Results.SetNum(Queries.Num());
+		OnComplete.ExecuteIfBound(Results);
+		return;
+	}
 
-	for (int32 i = 0; i < NoiseLayers.Num(); i++)
+	Pathfinder->FindPathsAsync(Queries, MakePathCosts(), [OnComplete](TArray<FPlanetPathResult>&& Results)
 	{
-		const FNoiseLayer& NoiseLayer = NoiseLayers[i];
-		if (!NoiseLayer.Enabled)
+		OnComplete.ExecuteIfBound(Results);
+	});
+}
+
+void APlanetActor::BuildOcean(TSharedPtr<const FPlanetOceanShell> Shell)
+{
+	if (!Shell.IsValid())
+	{
+		if (OceanMeshResolution != INDEX_NONE)
 		{
-			continue;
+			OceanMesh->ClearAllMeshSections();
+			OceanMeshResolution = INDEX_NONE;
 		}
+		return;
+	}
 
-		float Amplitude = 1;
-		float Frequency = NoiseLayer.BaseRoughness;
-		float NoiseValue = 0;
+	// The shared shell only needs uploading when its resolution changes; sea level is just a scale
+	if (OceanMeshResolution != OceanResolution)
+	{
+		OceanMesh->ClearAllMeshSections();
+		OceanMesh->CreateMeshSection_LinearColor(0, Shell->Positions, Shell->Triangles, Shell->Positions, Shell->UVs, TArray<FLinearColor>(), TArray<FProcMeshTangent>(), true);
+		OceanMeshResolution = OceanResolution;
+	}
+	OceanMesh->SetRelativeScale3D(FVector(GetOceanRadius()));
 
-		for (int32 j = 0; j < NoiseLayer.NumLayers; j++)
+	UMaterialInterface* WaterMaterial = OceanMaterial;
+	if (!WaterMaterial)
+	{
+		if (!DefaultOceanMaterial)
 		{
-			FVector SamplePoint = PointOnUnitSphere * Frequency + NoiseLayer.Center;
+			DefaultOceanMaterial = UPlanetMaterialGenerator::CreateOceanMaterial(this);
+		}
+		WaterMaterial = DefaultOceanMaterial;
+	}
+	OceanMesh->SetMaterial(0, WaterMaterial);
 
-			// Use SimplexNoise from the SimplexNoiseBPLibrary
-			float Noise = USimplexNoiseBPLibrary::SimplexNoise3D(SamplePoint.X, SamplePoint.Y, SamplePoint.Z);
-			NoiseValue += (Noise + 1) * 0.5f * Amplitude;
+	UE_LOG(LogTemp, Log, TEXT("Ocean hides %d of %d terrain triangles"), GetSubmergedTriangleCount(), Triangles.Num() / 3);
+}
 
-			Frequency *= NoiseLayer.Roughness;
-			Amplitude *= NoiseLayer.Persistence;
+void APlanetActor::BuildCollision(const FPlanetBuildResult& Result)
+{
+	if (CollisionMode == EPlanetCollisionMode::LowResolution && Result.CollisionVertices.Num() > 0)
+	{
+		PlanetMesh->CreateMeshSection_LinearColor(CollisionSectionIndex, Result.CollisionVertices, Result.CollisionTriangles, TArray<FVector>(), TArray<FVector2D>(), TArray<FLinearColor>(), TArray<FProcMeshTangent>(), true);
+		PlanetMesh->SetMeshSectionVisible(CollisionSectionIndex, false);
+	}
+	else if (PlanetMesh->GetNumSections() > CollisionSectionIndex)
+	{
+		PlanetMesh->ClearMeshSection(CollisionSectionIndex);
+	}
+
+	CollisionSphere->SetSphereRadius(HasOcean ? FMath::Max(PlanetRadius, GetOceanRadius()) : PlanetRadius);
+
+	ApplyCollisionSettings();
+}
+
+void APlanetActor::ApplyCollisionSettings()
+{
+	const bool bMeshCollision = CollisionMode == EPlanetCollisionMode::RenderMesh || CollisionMode == EPlanetCollisionMode::LowResolution;
+
+	PlanetMesh->bUseComplexAsSimpleCollision = true;
+	PlanetMesh->SetCollisionEnabled(bMeshCollision ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
+	PlanetMesh->SetCollisionResponseToAllChannels(ECR_Block);
+	PlanetMesh->SetGenerateOverlapEvents(bMeshCollision);
+
+	// Render mesh collision is cooked by whichever component draws the surface
+	const bool bSurfaceCollision = UsePlanetMeshComponent && CollisionMode == EPlanetCollisionMode::RenderMesh;
+	PlanetSurface->SetCollisionEnabled(bSurfaceCollision ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
+	PlanetSurface->SetCollisionResponseToAllChannels(ECR_Block);
+	PlanetSurface->SetGenerateOverlapEvents(bSurfaceCollision);
+
+	CollisionSphere->SetCollisionEnabled(CollisionMode == EPlanetCollisionMode::Sphere ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
+}
+
+float APlanetActor::GetOceanRadius() const
+{
+	// Same height scale as CalculatePointOnPlanet
+	return PlanetRadius * (1.0f + OceanLevel * 0.2f);
+}
+
+int32 APlanetActor::GetSubmergedTriangleCount() const
+{
+	return RenderTriangles.Num() > 0 ? (Triangles.Num() - RenderTriangles.Num()) / 3 : 0;
+}
+
+void APlanetActor::BuildBiomePalette(TArray<FLinearColor>& OutColors, TArray<FLinearColor>& OutSurfaceParameters) const
+{
+	OutColors.Init(FLinearColor::Black, UPlanetMaterialGenerator::BiomePaletteWidth);
+	OutSurfaceParameters.Init(FLinearColor(0.8f, 0.0f, 0.5f, EmissiveStrength), UPlanetMaterialGenerator::BiomePaletteWidth);
+
+	// Surface parameters come from each biome's material, with the planet defaults where it has none
+	auto ReadSurfaceParameters = [this](const UMaterialInterface* Material) -> FLinearColor
+	{
+		FLinearColor Parameters(0.8f, 0.0f, 0.5f, EmissiveStrength);
+		if (Material)
+		{
+			Material->GetScalarParameterValue(FHashedMaterialParameterInfo(FName("Roughness")), Parameters.R);
+			Material->GetScalarParameterValue(FHashedMaterialParameterInfo(FName("Metallic")), Parameters.G);
+			Material->GetScalarParameterValue(FHashedMaterialParameterInfo(FName("Specular")), Parameters.B);
+			Material->GetScalarParameterValue(FHashedMaterialParameterInfo(FName("EmissiveStrength")), Parameters.A);
 		}
+		return Parameters;
+	};
+
+	// Slots follow the lookup table the mesh was generated with, the last one being the no-match slot
+	const int32 NumSlots = FMath::Min(BiomeLookup.GetNumSlots() + 1, (int32)FPlanetMeshBuilder::HighlightPaletteSlot);
+	for (int32 Slot = 0; Slot < NumSlots; Slot++)
+	{
+		const EBiomeType BiomeType = BiomeLookup.GetBiomeType(Slot);
+		OutColors[Slot] = BiomeLookup.GetColor(Slot);
 
-		if (NoiseLayer.MinValue > 0)
+		// Like the colours, the first biome of a type supplies its surface parameters
+		for (const FBiomeSettings& Biome : Biomes)
 		{
-			NoiseValue = FMath::Max(0.0f, NoiseValue - NoiseLayer.MinValue);
+			if (Biome.BiomeType == BiomeType)
+			{
+				OutColors[Slot] = Biome.BiomeColor;
+				OutSurfaceParameters[Slot] = ReadSurfaceParameters(Biome.BiomeMaterial);
+				break;
+			}
 		}
+	}
+
+	FLinearColor HighlightColor = SelectedTileColor * SelectedTileHighlightIntensity;
+	HighlightColor.A = 1.0f;
+	OutColors[FPlanetMeshBuilder::HighlightPaletteSlot] = HighlightColor;
+}
+
+void APlanetActor::ApplyBiomePalette()
+{
+	TArray<FLinearColor> Colors;
+	TArray<FLinearColor> SurfaceParameters;
+	BuildBiomePalette(Colors, SurfaceParameters);
+
+	if (BiomePaletteTexture)
+	{
+		UPlanetMaterialGenerator::UpdateBiomePaletteTexture(BiomePaletteTexture, Colors, SurfaceParameters);
+	}
+	else
+	{
+		BiomePaletteTexture = UPlanetMaterialGenerator::CreateBiomePaletteTexture(Colors, SurfaceParameters);
+	}
+
+	if (UMaterialInstanceDynamic* DynamicMaterial = GetSurfaceMaterialInstance())
+	{
+		DynamicMaterial->SetTextureParameterValue(FName("BiomePalette"), BiomePaletteTexture);
+		DynamicMaterial->SetScalarParameterValue(FName("BiomePaletteSize"), (float)UPlanetMaterialGenerator::BiomePaletteWidth);
+		DynamicMaterial->SetScalarParameterValue(FName("UseBiomePalette"), 1.0f);
+	}
+}
+
+UMaterialInstanceDynamic* APlanetActor::GetSurfaceMaterialInstance()
+{
+	// Reuse the planet material if it already is a dynamic instance
+	if (UMaterialInstanceDynamic* DynamicMaterial = Cast<UMaterialInstanceDynamic>(PlanetMaterial))
+	{
+		SurfaceMaterialInstance = DynamicMaterial;
+	}
+	else if (!SurfaceMaterialInstance || (PlanetMaterial && SurfaceMaterialInstance->Parent != PlanetMaterial))
+	{
+		SurfaceMaterialInstance = PlanetMaterial ? UMaterialInstanceDynamic::Create(PlanetMaterial, this) : UPlanetMaterialGenerator::CreatePlanetMaterial(this);
+	}
+
+	return SurfaceMaterialInstance;
+}
+
+UMaterialInterface* APlanetActor::GetSurfaceMaterial() const
+{
+	const bool bNeedsInstance = bMeshUsesBiomePalette || (SurfaceBake.IsValid() && SurfaceMaterialHasTexture(FName("PlanetAlbedo")));
+	return bNeedsInstance && SurfaceMaterialInstance ? SurfaceMaterialInstance : PlanetMaterial;
+}
+
+bool APlanetActor::SurfaceMaterialHasTexture(FName ParameterName) const
+{
+	// Without a PlanetMaterial the surface instance is created from the plugin's base material
+	const UMaterialInterface* Material = PlanetMaterial ? PlanetMaterial : UPlanetMaterialGenerator::GetPlanetBaseMaterial();
+	return UPlanetMaterialGenerator::HasTextureParameter(Material, ParameterName);
+}
 
-		NoiseValue *= NoiseLayer.Strength;
+UMeshComponent* APlanetActor::GetSurfaceComponent() const
+{
+	return PlanetSurface && PlanetSurface->GetNumVertices() > 0 ? (UMeshComponent*)PlanetSurface : (UMeshComponent*)PlanetMesh;
+}
 
-		if (i == 0)
+void APlanetActor::UploadVertexColors(TArrayView<const int32> ChangedVertices)
+{
+	if (PlanetSurface->GetNumVertices() == VertexColors.Num() && VertexColors.Num() > 0)
+	{
+		// Converted like the build converts them; the component batches the changed vertices into ranges
+		if (ChangedVertices.Num() == 0)
 		{
-			FirstLayerValue = NoiseValue;
+			TArray<FColor> Colors;
+			Colors.SetNumUninitialized(VertexColors.Num());
+			for (int32 i = 0; i < VertexColors.Num(); i++)
+			{
+				Colors[i] = VertexColors[i].ToFColor(false);
+			}
+			PlanetSurface->UpdateVertexColors(0, Colors);
 		}
 		else
 		{
-			float Mask = FirstLayerValue;
-			NoiseValue *= Mask;
+			TArray<FColor> Colors;
+			Colors.SetNumUninitialized(ChangedVertices.Num());
+			for (int32 i = 0; i < ChangedVertices.Num(); i++)
+			{
+				Colors[i] = VertexColors[ChangedVertices[i]].ToFColor(false);
+			}
+			PlanetSurface->UpdateVertexColors(ChangedVertices, Colors);
 		}
-
-		Elevation += NoiseValue * Weight;
-		Weight *= 0.5f;
+		return;
 	}
 
-	return Elevation;
+	// The procedural mesh only updates whole streams, but leaves positions and collision alone
+	if (PlanetMesh->GetNumSections() > 0)
+	{
+		PlanetMesh->UpdateMeshSection_LinearColor(0, TArray<FVector>(), TArray<FVector>(), TArray<FVector2D>(), VertexColors, TArray<FProcMeshTangent>());
+	}
 }
 
-FVector APlanetActor::CalculatePointOnPlanet(const FVector& PointOnUnitSphere)
+bool APlanetActor::BakeSurface()
 {
-	float Elevation = EvaluateNoise(PointOnUnitSphere);
-	float FinalElevation = PlanetRadius * (1 + Elevation * 0.2f);
-	return PointOnUnitSphere * FinalElevation;
+	if (BakeFaceResolution <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BakeSurface: Invalid face resolution %d"), BakeFaceResolution);
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FPlanetMeshBuilder Builder(MakeBuildSettings());
+	Builder.BakeSurface(BakeFaceResolution, SurfaceBake);
+	UploadSurfaceBake();
+
+	UE_LOG(LogTemp, Log, TEXT("Baked %dx%d surface textures in %.2f ms"), SurfaceBake.GetWidth(), SurfaceBake.GetHeight(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return BakedHeightTexture && BakedAlbedoTexture && BakedNormalTexture;
 }
 
-float APlanetActor::GetTemperature(const FVector& PointOnUnitSphere)
+void APlanetActor::UploadSurfaceBake()
 {
-	// Temperature decreases from equator to poles
-	float LatitudeFactor = 1.0f - FMath::Abs(PointOnUnitSphere.Z);
-	float Temperature = FMath::Lerp(PoleTemperature, EquatorTemperature, LatitudeFactor);
+	const int32 Width = SurfaceBake.GetWidth();
+	const int32 Height = SurfaceBake.GetHeight();
+	BakedHeightTexture = UPlanetMaterialGenerator::CreateDataTexture(Width, Height, PF_R32_FLOAT, SurfaceBake.Heights.GetData(), sizeof(float), false);
+	BakedAlbedoTexture = UPlanetMaterialGenerator::CreateDataTexture(Width, Height, PF_B8G8R8A8, SurfaceBake.Albedo.GetData(), sizeof(FColor), true);
+	BakedNormalTexture = UPlanetMaterialGenerator::CreateDataTexture(Width, Height, PF_B8G8R8A8, SurfaceBake.Normals.GetData(), sizeof(FColor), false);
 
-	// Add some noise for more natural temperature distribution
-	FVector SamplePoint = PointOnUnitSphere * 3.7f;
-	float TemperatureNoise = USimplexNoiseBPLibrary::SimplexNoise3D(SamplePoint.X, SamplePoint.Y, SamplePoint.Z) * 0.1f;
-
-	return FMath::Clamp(Temperature + TemperatureNoise, 0.0f, 1.0f);
+	ApplySurfaceBake();
 }
 
-float APlanetActor::GetMoisture(const FVector& PointOnUnitSphere)
+void APlanetActor::ApplySurfaceBake()
 {
-	// Base moisture with noise
-	FVector SamplePoint = PointOnUnitSphere * 5.3f * MoistureScale;
-	float Moisture = (USimplexNoiseBPLibrary::SimplexNoise3D(SamplePoint.X, SamplePoint.Y, SamplePoint.Z) + 1.0f) * 0.5f;
+	// The textures stay available to Blueprints, but a material without the parameters keeps
+	// drawing the mesh as it is
+	if (!SurfaceMaterialHasTexture(FName("PlanetAlbedo")))
+	{
+		return;
+	}
 
-	// Moisture tends to be higher near the equator and lower near the poles
-	float LatitudeFactor = 1.0f - FMath::Abs(PointOnUnitSphere.Z);
-	Moisture *= FMath::Lerp(0.7f, 1.0f, LatitudeFactor);
+	UMaterialInstanceDynamic* DynamicMaterial = GetSurfaceMaterialInstance();
+	if (!DynamicMaterial)
+	{
+		return;
+	}
 
-	return FMath::Clamp(Moisture, 0.0f, 1.0f);
+	DynamicMaterial->SetTextureParameterValue(FName("PlanetAlbedo"), BakedAlbedoTexture);
+	DynamicMaterial->SetTextureParameterValue(FName("PlanetHeight"), BakedHeightTexture);
+	DynamicMaterial->SetTextureParameterValue(FName("PlanetNormal"), BakedNormalTexture);
+	DynamicMaterial->SetScalarParameterValue(FName("BakedFaceResolution"), (float)SurfaceBake.FaceResolution);
+	DynamicMaterial->SetScalarParameterValue(FName("UseBakedSurface"), SurfaceBake.IsValid() ? 1.0f : 0.0f);
+
+	if (UMeshComponent* SurfaceComponent = GetSurfaceComponent())
+	{
+		SurfaceComponent->SetMaterial(0, DynamicMaterial);
+	}
 }
 
-EBiomeType APlanetActor::DetermineBiome(float Height, float Temperature, float Moisture)
+#if WITH_EDITOR
+void APlanetActor::BakeToStaticMesh()
 {
-	// Then check all other biomes
-	for (const FBiomeSettings& Biome : Biomes)
+	if (CachedVertices.Num() == 0)
+	{
+		GeneratePlanet();
+	}
+
+	// Palette indices mean nothing without the palette texture, so the asset gets the final colours
+	TArray<FLinearColor> ExportColors = VertexColors;
+	if (bMeshUsesBiomePalette)
 	{
-		if (Height >= Biome.MinHeight && Height <= Biome.MaxHeight &&
-			Temperature >= Biome.MinTemperature && Temperature <= Biome.MaxTemperature &&
-			Moisture >= Biome.MinMoisture && Moisture <= Biome.MaxMoisture)
+		TArray<FLinearColor> PaletteColors;
+		TArray<FLinearColor> SurfaceParameters;
+		BuildBiomePalette(PaletteColors, SurfaceParameters);
+		for (FLinearColor& Color : ExportColors)
 		{
-			return Biome.BiomeType;
+			Color = PaletteColors[FMath::Clamp(FMath::RoundToInt(Color.R * 255.0f), 0, PaletteColors.Num() - 1)];
 		}
 	}
 
-	// Default to plains if no match
-	return EBiomeType::Plains;
+	// Dynamic instances are transient; the asset references the material they were made from
+	UMaterialInterface* Material = PlanetMaterial;
+	while (UMaterialInstanceDynamic* DynamicMaterial = Cast<UMaterialInstanceDynamic>(Material))
+	{
+		Material = DynamicMaterial->Parent;
+	}
+
+	FPlanetStaticMeshSource Source;
+	Source.Positions = CachedVertices;
+	// All triangles, since the ocean shell is not part of the asset
+	Source.Triangles = Triangles;
+	Source.Normals = Normals;
+	Source.UV0 = UV0;
+	Source.VertexColors = ExportColors;
+	Source.Tangents = Tangents;
+	Source.Attributes = Attributes.Get();
+	Source.Material = Material;
+
+	const FString Folder = StaticMeshFolder.Path.IsEmpty() ? FString(TEXT("/Game/Planets")) : StaticMeshFolder.Path;
+	const FString AssetName = StaticMeshName.IsEmpty() ? FString::Printf(TEXT("SM_%s"), *GetName()) : StaticMeshName;
+
+	FPlanetStaticMeshExportSettings Settings;
+	Settings.PackageName = Folder / AssetName;
+	Settings.bEnableNanite = StaticMeshNanite;
+	Settings.NumLODs = StaticMeshLODs;
+	Settings.bGenerateCollision = StaticMeshCollision;
+
+	FPlanetStaticMeshExporter::Export(Source, Settings);
 }
+#endif
 
-FLinearColor APlanetActor::GetBiomeColor(EBiomeType BiomeType, float Height, float Temperature, float Moisture)
+void APlanetActor::SetBiomeColor(EBiomeType BiomeType, FLinearColor NewColor)
 {
-	for (const FBiomeSettings& Biome : Biomes)
+	for (FBiomeSettings& Biome : Biomes)
 	{
 		if (Biome.BiomeType == BiomeType)
 		{
-			return Biome.BiomeColor;
+			Biome.BiomeColor = NewColor;
 		}
 	}
 
-	// Default color if biome not found
-	return FLinearColor(0.5f, 0.5f, 0.5f, 1.0f);
+	if (bMeshUsesBiomePalette)
+	{
+		ApplyBiomePalette();
+	}
+	else if (AutoUpdate)
+	{
+		// Baked colours can only change by regenerating
+		MarkGenerationDirty();
+	}
+}
+
+void APlanetActor::RefreshBiomePalette()
+{
+	if (!bMeshUsesBiomePalette)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RefreshBiomePalette: Planet was not generated in BiomePalette color mode"));
+		return;
+	}
+
+	ApplyBiomePalette();
 }
 
 bool APlanetActor::SelectTileAtScreenPosition(APlayerController* PlayerController, FVector2D ScreenPosition)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(APlanetActor::SelectTileAtScreenPosition);
+	SCOPE_CYCLE_COUNTER(STAT_PlanetTileSelection);
+
 	if (!EnableTileSelection)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Tile selection is disabled. EnableTileSelection = false"));
@@ -513,17 +1372,8 @@ bool APlanetActor::SelectTileAtScreenPosition(APlayerController* PlayerControlle
 	// Check if we have triangles data
 	if (Triangles.Num() == 0)
 	{
-		// Try to use stored triangles if available
-		if (StoredTriangles.Num() > 0)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Using stored triangles as fallback"));
-			Triangles = StoredTriangles;
-		}
-		else
-		{
-			UE_LOG(LogTemp, Error, TEXT("SelectTileAtScreenPosition: Triangles array is empty. Planet may not be properly generated."));
-			return false;
-		}
+		UE_LOG(LogTemp, Error, TEXT("SelectTileAtScreenPosition: Triangles array is empty. Planet may not be properly generated."));
+		return false;
 	}
 
 	// First clear any existing selection
@@ -653,13 +1503,8 @@ bool APlanetActor::SelectTileAtScreenPosition(APlayerController* PlayerControlle
 	// Store the hit location
 	SelectedTileLocation = HitResult.Location;
 
-	// Determine the biome at this location
-	FVector PointOnUnitSphere = (HitResult.Location - GetActorLocation()).GetSafeNormal();
-	float Height = (HitResult.Location - GetActorLocation()).Size() / PlanetRadius - 1.0f;
-	Height = FMath::Clamp(Height * 5.0f, 0.0f, 1.0f); // Scale height to 0-1 range
-	float Temperature = GetTemperature(PointOnUnitSphere);
-	float Moisture = GetMoisture(PointOnUnitSphere);
-	SelectedTileBiome = DetermineBiome(Height, Temperature, Moisture);
+	// Read the biome recorded for this tile during generation
+	SelectedTileBiome = GetTileBiome(SelectedTileIndex);
 
 	UE_LOG(LogTemp, Log, TEXT("Selected tile biome: %s"), *UEnum::GetValueAsString(SelectedTileBiome));
 
@@ -670,6 +1515,9 @@ bool APlanetActor::SelectTileAtScreenPosition(APlayerController* PlayerControlle
 		UE_LOG(LogTemp, Warning, TEXT("Failed to update visual for selected tile"));
 	}
 
+	// Tick only while the outline needs redrawing on a moving planet
+	SetActorTickEnabled(AutoRotate || AutoOrbit || HasScriptTick());
+
 	// Trigger the blueprint event
 	OnTileSelected(SelectedTileIndex, SelectedTileLocation, SelectedTileBiome);
 
@@ -686,62 +1534,34 @@ void APlanetActor::ClearSelectedTile()
 		// Restore original colors if we have them
 		if (OriginalVertexColors.Num() > 0 && VertexColors.Num() == OriginalVertexColors.Num())
 		{
-			// Restore the original colors
-			VertexColors = OriginalVertexColors;
-
-			// Update the mesh section with the original colors
-			FProcMeshSection* MeshSection = PlanetMesh->GetProcMeshSection(0);
-			if (MeshSection && MeshSection->ProcVertexBuffer.Num() > 0)
+			// Only the highlighted vertices differ from the originals
+			TArray<int32> ChangedVertices;
+			for (int32 i = 0; i < VertexColors.Num(); i++)
 			{
-				// Get the vertices from the mesh section
-				TArray<FVector> Positions;
-				TArray<FVector> MeshNormals;
-				TArray<FVector2D> MeshUVs;
-				TArray<FProcMeshTangent> MeshTangents;
-
-				Positions.SetNum(MeshSection->ProcVertexBuffer.Num());
-				MeshNormals.SetNum(MeshSection->ProcVertexBuffer.Num());
-				MeshUVs.SetNum(MeshSection->ProcVertexBuffer.Num());
-				MeshTangents.SetNum(MeshSection->ProcVertexBuffer.Num());
-
-				for (int32 i = 0; i < MeshSection->ProcVertexBuffer.Num(); i++)
+				if (VertexColors[i] != OriginalVertexColors[i])
 				{
-					Positions[i] = MeshSection->ProcVertexBuffer[i].Position;
-					MeshNormals[i] = MeshSection->ProcVertexBuffer[i].Normal;
-					MeshUVs[i] = MeshSection->ProcVertexBuffer[i].UV0;
-					MeshTangents[i] = MeshSection->ProcVertexBuffer[i].Tangent;
+					ChangedVertices.Add(i);
 				}
+			}
 
-				// Create a new mesh section with the updated colors
-				PlanetMesh->ClearMeshSection(0);
-				PlanetMesh->CreateMeshSection_LinearColor(0, Positions, Triangles, MeshNormals, MeshUVs, VertexColors, MeshTangents, true);
+			// Restore the original colors
+			VertexColors = OriginalVertexColors;
 
-				// Reapply the material
-				if (PlanetMaterial)
-				{
-					PlanetMesh->SetMaterial(0, PlanetMaterial);
-				}
+			if (ChangedVertices.Num() > 0)
+			{
+				UploadVertexColors(ChangedVertices);
 			}
 
 			// Clear the original colors cache
 			OriginalVertexColors.Empty();
 		}
 	}
-
-	// Make sure we have triangles data
-	if (Triangles.Num() == 0 && StoredTriangles.Num() > 0)
-	{
-		Triangles = StoredTriangles;
-	}
 }
 
 bool APlanetActor::UpdateSelectedTileVisual()
 {
-	// Make sure we have triangles data
-	if (Triangles.Num() == 0 && StoredTriangles.Num() > 0)
-	{
-		Triangles = StoredTriangles;
-	}
+	TRACE_CPUPROFILER_EVENT_SCOPE(APlanetActor::UpdateSelectedTileVisual);
+	SCOPE_CYCLE_COUNTER(STAT_PlanetTileSelection);
 
 	if (SelectedTileIndex < 0 || SelectedTileIndex >= Triangles.Num() / 3)
 	{
@@ -776,6 +1596,14 @@ bool APlanetActor::UpdateSelectedTileVisual()
 		UE_LOG(LogTemp, Log, TEXT("Highlight color: R=%f, G=%f, B=%f"),
 			HighlightColor.R, HighlightColor.G, HighlightColor.B);
 
+		// In palette mode the highlight lives in its own palette slot
+		if (bMeshUsesBiomePalette)
+		{
+			ApplyBiomePalette();
+			const float HighlightSlot = FPlanetMeshBuilder::HighlightPaletteSlot / 255.0f;
+			HighlightColor = FLinearColor(HighlightSlot, 0.0f, HighlightSlot, 1.0f);
+		}
+
 		// Modify the colors for the selected triangle
 		NewColors[Index1] = HighlightColor;
 		NewColors[Index2] = HighlightColor;
@@ -784,47 +1612,22 @@ bool APlanetActor::UpdateSelectedTileVisual()
 		// Update the vertex colors
 		VertexColors = NewColors;
 
-		// Get the mesh section
-		FProcMeshSection* MeshSection = PlanetMesh->GetProcMeshSection(0);
-		if (MeshSection && MeshSection->ProcVertexBuffer.Num() > 0)
-		{
-			// Get the vertices from the mesh section
-			TArray<FVector> Positions;
-			TArray<FVector> MeshNormals;
-			TArray<FVector2D> MeshUVs;
-			TArray<FProcMeshTangent> MeshTangents;
-
-			Positions.SetNum(MeshSection->ProcVertexBuffer.Num());
-			MeshNormals.SetNum(MeshSection->ProcVertexBuffer.Num());
-			MeshUVs.SetNum(MeshSection->ProcVertexBuffer.Num());
-			MeshTangents.SetNum(MeshSection->ProcVertexBuffer.Num());
+		// Send just the three changed colours; positions, normals and collision stay as they are
+		const int32 ChangedVertices[3] = { Index1, Index2, Index3 };
+		UploadVertexColors(ChangedVertices);
 
-			for (int32 i = 0; i < MeshSection->ProcVertexBuffer.Num(); i++)
-			{
-				Positions[i] = MeshSection->ProcVertexBuffer[i].Position;
-				MeshNormals[i] = MeshSection->ProcVertexBuffer[i].Normal;
-				MeshUVs[i] = MeshSection->ProcVertexBuffer[i].UV0;
-				MeshTangents[i] = MeshSection->ProcVertexBuffer[i].Tangent;
-			}
-
-			// Create a new mesh section with the updated colors
-			PlanetMesh->ClearMeshSection(0);
-			PlanetMesh->CreateMeshSection_LinearColor(0, Positions, Triangles, MeshNormals, MeshUVs, VertexColors, MeshTangents, true);
-
-			// Reapply the material
-			if (PlanetMaterial)
-			{
-				PlanetMesh->SetMaterial(0, PlanetMaterial);
-			}
+		// Make sure the material uses vertex colors
+		UMaterialInstanceDynamic* DynamicMaterial = Cast<UMaterialInstanceDynamic>(GetSurfaceComponent()->GetMaterial(0));
+		if (DynamicMaterial)
+		{
+			DynamicMaterial->SetScalarParameterValue(FName("UseVertexColors"), 1.0f);
+		}
 
-			// Make sure the material uses vertex colors
-			UMaterialInstanceDynamic* DynamicMaterial = Cast<UMaterialInstanceDynamic>(PlanetMesh->GetMaterial(0));
-			if (DynamicMaterial)
-			{
-				DynamicMaterial->SetScalarParameterValue(FName("UseVertexColors"), 1.0f);
-			}
+		UE_LOG(LogTemp, Log, TEXT("Updated mesh section with new vertex colors"));
 
-			UE_LOG(LogTemp, Log, TEXT("Updated mesh section with new vertex colors"));
+		if (CachedVertices.IsValidIndex(Index1) && CachedVertices.IsValidIndex(Index2) && CachedVertices.IsValidIndex(Index3))
+		{
+			const TArray<FVector>& Positions = CachedVertices;
 
 			// Store the selected triangle world positions for later use
 			FVector V1 = GetActorTransform().TransformPosition(Positions[Index1]);
@@ -858,20 +1661,14 @@ bool APlanetActor::UpdateSelectedTileVisual()
 
 int32 APlanetActor::FindTriangleIndexFromHitLocation(const FVector& HitLocation)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(APlanetActor::FindTriangleIndexFromHitLocation);
+	SCOPE_CYCLE_COUNTER(STAT_PlanetTileSelection);
+
 	// First check if we have triangles data
 	if (Triangles.Num() == 0)
 	{
-		// Try to use stored triangles if available
-		if (StoredTriangles.Num() > 0)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Using stored triangles as fallback"));
-			Triangles = StoredTriangles;
-		}
-		else
-		{
-			UE_LOG(LogTemp, Error, TEXT("FindTriangleIndexFromHitLocation: Triangles array is empty"));
-			return -1;
-		}
+		UE_LOG(LogTemp, Error, TEXT("FindTriangleIndexFromHitLocation: Triangles array is empty"));
+		return -1;
 	}
 
 	// Check if we have cached vertices
@@ -899,6 +1696,14 @@ int32 APlanetActor::FindTriangleIndexFromHitLocation(const FVector& HitLocation)
 	UE_LOG(LogTemp, Log, TEXT("FindTriangleIndexFromHitLocation: Vertex count: %d, Triangle count: %d"),
 		CachedVertices.Num(), Triangles.Num() / 3);
 
+	// Use the spatial index when the tiles match the current triangles
+	if (SpatialIndex.IsValid() && TileGraph.IsValid() && TileGraph->GetNumTiles() == Triangles.Num() / 3)
+	{
+		int32 TileIndex = FindTileAtLocation(HitLocation);
+		UE_LOG(LogTemp, Log, TEXT("FindTriangleIndexFromHitLocation: Found triangle at index %d using spatial index"), TileIndex);
+		return TileIndex;
+	}
+
 	// Find the closest triangle
 	float ClosestDistanceSq = MAX_FLT;
 	int32 ClosestTriangleIndex = -1;
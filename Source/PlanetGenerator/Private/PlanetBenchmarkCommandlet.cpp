@@ -0,0 +1,183 @@
+#include "PlanetBenchmarkCommandlet.h"
+#include "PlanetActor.h"
+#include "PlanetMeshBuilder.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+TArray<int32> UPlanetBenchmarkCommandlet::ParseIntList(const FString& Text)
+{
+	TArray<int32> Values;
+
+	TArray<FString> Entries;
+	Text.ParseIntoArray(Entries, TEXT(","));
+	for (const FString& Entry : Entries)
+	{
+		FString Low, High;
+		if (Entry.Split(TEXT("-"), &Low, &High))
+		{
+			for (int32 Value = FCString::Atoi(*Low); Value <= FCString::Atoi(*High); Value++)
+			{
+				Values.Add(Value);
+			}
+		}
+		else
+		{
+			Values.Add(FCString::Atoi(*Entry));
+		}
+	}
+
+	return Values;
+}
+
+static TArray<int32> ParseIntListParam(const FString& Params, const TCHAR* Name, const TCHAR* Default)
+{
+	FString Text = Default;
+	FParse::Value(*Params, Name, Text);
+	return UPlanetBenchmarkCommandlet::ParseIntList(Text);
+}
+
+UPlanetBenchmarkCommandlet::UPlanetBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UPlanetBenchmarkCommandlet::Main(const FString& Params)
+{
+	const TArray<int32> Resolutions = ParseIntListParam(Params, TEXT("Resolutions="), TEXT("0-8"));
+	const TArray<int32> LayerCounts = ParseIntListParam(Params, TEXT("Layers="), TEXT("1,2,4"));
+	const TArray<int32> OctaveCounts = ParseIntListParam(Params, TEXT("Octaves="), TEXT("4,8"));
+	const TArray<int32> WorkerCounts = ParseIntListParam(Params, TEXT("Workers="), TEXT("0"));
+	const TArray<int32> Concurrencies = ParseIntListParam(Params, TEXT("Concurrency="), TEXT("1"));
+	const TArray<int32> OrderModes = ParseIntListParam(Params, TEXT("OptimizeOrder="), TEXT("0"));
+
+	int32 Iterations = 3;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	Iterations = FMath::Max(Iterations, 1);
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("PlanetBenchmark") / FString::Printf(TEXT("PlanetBenchmark-%s.csv"), *FDateTime::Now().ToString());
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	// Default planet settings, so the biome and climate passes see a realistic biome list
+	const FPlanetBuildSettings BaseSettings = GetDefault<APlanetActor>()->MakeBuildSettings();
+	const FNoiseLayer BaseLayer = BaseSettings.NoiseLayers.Num() > 0 ? BaseSettings.NoiseLayers[0] : FNoiseLayer();
+
+	// Warm up lazily built tables so the first timed run is not an outlier
+	{
+		FPlanetBuildResult WarmUp;
+		FPlanetMeshBuilder(BaseSettings).Build(WarmUp);
+	}
+
+	const int32 NumTaskGraphWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads();
+	UE_LOG(LogTemp, Display, TEXT("PlanetBenchmark: %d task graph workers"), NumTaskGraphWorkers);
+
+	TArray<FString> Lines;
+	Lines.Add(TEXT("Resolution,NoiseLayers,Octaves,OptimizeOrder,TaskGraphWorkers,Workers,Concurrency,Iteration,Vertices,Triangles,WallMs,BuildMs,SubdivisionMs,ReorderMs,TopologyMs,NoiseMs,ClimateMs,BiomeMs,TangentsMs,OceanMs,CollisionMs,BakeMs,BytesAllocated,UsedPhysicalDeltaBytes,PeakUsedPhysicalBytes,VerticesPerSecond,ACMRBefore,ACMRAfter,FetchMissesBefore,FetchMissesAfter"));
+
+	for (int32 Resolution : Resolutions)
+	{
+		for (int32 NumLayers : LayerCounts)
+		{
+			for (int32 Octaves : OctaveCounts)
+			{
+				FPlanetBuildSettings Settings = BaseSettings;
+				Settings.Resolution = Resolution;
+
+				// Offset each layer so they do not sample identical noise
+				Settings.NoiseLayers.Reset();
+				for (int32 Layer = 0; Layer < NumLayers; Layer++)
+				{
+					FNoiseLayer& NoiseLayer = Settings.NoiseLayers.Add_GetRef(BaseLayer);
+					NoiseLayer.NumLayers = Octaves;
+					NoiseLayer.Center = BaseLayer.Center + FVector(Layer * 17.0f);
+				}
+
+				for (int32 OptimizeOrder : OrderModes)
+				{
+					Settings.bOptimizeMeshOrder = OptimizeOrder != 0;
+
+					for (int32 MaxWorkers : WorkerCounts)
+					{
+						// The cap in effect: 0 or more than the task graph has means every worker
+						Settings.MaxWorkers = FMath::Max(MaxWorkers, 0);
+						const int32 Workers = Settings.MaxWorkers > 0 ? FMath::Min(Settings.MaxWorkers, NumTaskGraphWorkers) : NumTaskGraphWorkers;
+
+						for (int32 Concurrency : Concurrencies)
+						{
+							Concurrency = FMath::Max(Concurrency, 1);
+
+							for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+							{
+								TArray<FPlanetBuildResult> Results;
+								Results.SetNum(Concurrency);
+
+								const uint64 UsedBefore = FPlatformMemory::GetStats().UsedPhysical;
+								const double StartTime = FPlatformTime::Seconds();
+
+								ParallelFor(Concurrency, [&Settings, &Results](int32 Index)
+								{
+									FPlanetMeshBuilder(Settings).Build(Results[Index]);
+								}, Concurrency == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+								const double WallSeconds = FPlatformTime::Seconds() - StartTime;
+								const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+								const int64 UsedDelta = (int64)MemoryStats.UsedPhysical - (int64)UsedBefore;
+
+								// Stage timings are averaged over the concurrent builds
+								FPlanetGenerationStats Average;
+								for (const FPlanetBuildResult& Result : Results)
+								{
+									const FPlanetGenerationStats& Stats = Result.Stats;
+									Average.BuildMs += Stats.BuildMs / Concurrency;
+									Average.SubdivisionMs += Stats.SubdivisionMs / Concurrency;
+									Average.ReorderMs += Stats.ReorderMs / Concurrency;
+									Average.TopologyMs += Stats.TopologyMs / Concurrency;
+									Average.NoiseMs += Stats.NoiseMs / Concurrency;
+									Average.ClimateMs += Stats.ClimateMs / Concurrency;
+									Average.BiomeMs += Stats.BiomeMs / Concurrency;
+									Average.TangentsMs += Stats.TangentsMs / Concurrency;
+									Average.OceanMs += Stats.OceanMs / Concurrency;
+									Average.CollisionMs += Stats.CollisionMs / Concurrency;
+									Average.BakeMs += Stats.BakeMs / Concurrency;
+								}
+
+								const FPlanetGenerationStats& First = Results[0].Stats;
+								const double VerticesPerSecond = WallSeconds > 0.0 ? (double)First.NumVertices * Concurrency / WallSeconds : 0.0;
+
+								Lines.Add(FString::Printf(TEXT("%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%lld,%lld,%llu,%.0f,%.4f,%.4f,%.4f,%.4f"),
+									Resolution, NumLayers, Octaves, OptimizeOrder, NumTaskGraphWorkers, Workers, Concurrency, Iteration, First.NumVertices, First.NumTriangles,
+									WallSeconds * 1000.0, Average.BuildMs, Average.SubdivisionMs, Average.ReorderMs, Average.TopologyMs, Average.NoiseMs, Average.ClimateMs,
+									Average.BiomeMs, Average.TangentsMs, Average.OceanMs, Average.CollisionMs, Average.BakeMs,
+									First.BytesAllocated, UsedDelta, (uint64)MemoryStats.PeakUsedPhysical, VerticesPerSecond,
+									First.VertexCacheMissRatioBefore, First.VertexCacheMissRatioAfter, First.VertexFetchMissesBefore, First.VertexFetchMissesAfter));
+
+								UE_LOG(LogTemp, Display, TEXT("PlanetBenchmark: resolution %d, %d layers, %d octaves, order %d, %d workers, %d concurrent, run %d: %.2f ms, %.0f vertices/s"),
+									Resolution, NumLayers, Octaves, OptimizeOrder, Workers, Concurrency, Iteration, WallSeconds * 1000.0, VerticesPerSecond);
+
+								if (Settings.bOptimizeMeshOrder)
+								{
+									UE_LOG(LogTemp, Display, TEXT("PlanetBenchmark:   ACMR %.3f -> %.3f, vertex fetch misses per triangle %.3f -> %.3f"),
+										First.VertexCacheMissRatioBefore, First.VertexCacheMissRatioAfter, First.VertexFetchMissesBefore, First.VertexFetchMissesAfter);
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("PlanetBenchmark: Failed to write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("PlanetBenchmark: Wrote %d runs to %s"), Lines.Num() - 1, *OutputPath);
+	return 0;
+}
@@ -0,0 +1,154 @@
+#include "PlanetBiomeLookup.h"
+#include "PlanetActor.h"
+
+void FBiomeLookupTable::Build(const TArray<FBiomeSettings>& Biomes)
+{
+	Reset();
+
+	// Slots must fit below the sentinel values; longer lists keep using the linear scan
+	if (Biomes.Num() >= NoMatchCell)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FBiomeLookupTable: %d biomes exceed the table limit, using linear scan"), Biomes.Num());
+		return;
+	}
+
+	Bounds.Reserve(Biomes.Num());
+	SlotTypes.Reserve(Biomes.Num());
+	for (const FBiomeSettings& Biome : Biomes)
+	{
+		Bounds.Add({ Biome.MinHeight, Biome.MaxHeight, Biome.MinTemperature, Biome.MaxTemperature, Biome.MinMoisture, Biome.MaxMoisture });
+		SlotTypes.Add(Biome.BiomeType);
+	}
+
+	// Colours follow GetBiomeColor: the first biome of a type supplies the colour for that type
+	auto FindColor = [&Biomes](EBiomeType Type) -> FLinearColor
+	{
+		for (const FBiomeSettings& Biome : Biomes)
+		{
+			if (Biome.BiomeType == Type)
+			{
+				return Biome.BiomeColor;
+			}
+		}
+		return FLinearColor(0.5f, 0.5f, 0.5f, 1.0f);
+	};
+
+	SlotColors.Reserve(Biomes.Num() + 1);
+	for (const FBiomeSettings& Biome : Biomes)
+	{
+		SlotColors.Add(FindColor(Biome.BiomeType));
+	}
+	SlotColors.Add(FindColor(EBiomeType::Plains));
+
+	// Per axis, a biome range either covers a cell interval, misses it, or cuts through it.
+	// The margin pushes cells that merely touch a boundary into the ambiguous set.
+	enum class ECoverage : uint8 { None, Partial, Full };
+	const float Margin = 1.0e-4f;
+
+	auto GetCoverage = [Margin](float Low, float High, float Min, float Max) -> ECoverage
+	{
+		if (High < Min - Margin || Low > Max + Margin)
+		{
+			return ECoverage::None;
+		}
+		if (Min <= Low - Margin && High + Margin <= Max)
+		{
+			return ECoverage::Full;
+		}
+		return ECoverage::Partial;
+	};
+
+	const int32 N = GridResolution;
+	Cells.SetNumUninitialized(N * N * N);
+
+	for (int32 h = 0; h < N; h++)
+	{
+		const float HLow = (float)h / N;
+		const float HHigh = (float)(h + 1) / N;
+
+		for (int32 t = 0; t < N; t++)
+		{
+			const float TLow = (float)t / N;
+			const float THigh = (float)(t + 1) / N;
+
+			for (int32 m = 0; m < N; m++)
+			{
+				const float MLow = (float)m / N;
+				const float MHigh = (float)(m + 1) / N;
+
+				// First biome that could match decides the cell, unless it only covers part of it
+				uint16 Cell = NoMatchCell;
+				for (int32 Slot = 0; Slot < Bounds.Num(); Slot++)
+				{
+					const FBiomeBounds& B = Bounds[Slot];
+					ECoverage HCoverage = GetCoverage(HLow, HHigh, B.MinHeight, B.MaxHeight);
+					ECoverage TCoverage = GetCoverage(TLow, THigh, B.MinTemperature, B.MaxTemperature);
+					ECoverage MCoverage = GetCoverage(MLow, MHigh, B.MinMoisture, B.MaxMoisture);
+
+					if (HCoverage == ECoverage::None || TCoverage == ECoverage::None || MCoverage == ECoverage::None)
+					{
+						continue;
+					}
+
+					const bool bFull = HCoverage == ECoverage::Full && TCoverage == ECoverage::Full && MCoverage == ECoverage::Full;
+					Cell = bFull ? (uint16)Slot : (uint16)(Slot | AmbiguousFlag);
+					break;
+				}
+
+				Cells[(h * N + t) * N + m] = Cell;
+			}
+		}
+	}
+}
+
+void FBiomeLookupTable::Reset()
+{
+	Cells.Reset();
+	Bounds.Reset();
+	SlotTypes.Reset();
+	SlotColors.Reset();
+}
+
+int32 FBiomeLookupTable::Classify(float Height, float Temperature, float Moisture) const
+{
+	// The grid only spans the unit cube
+	if (Height < 0.0f || Height > 1.0f || Temperature < 0.0f || Temperature > 1.0f || Moisture < 0.0f || Moisture > 1.0f)
+	{
+		return ScanBounds(Height, Temperature, Moisture);
+	}
+
+	const uint16 Cell = Cells[(ToCell(Height) * GridResolution + ToCell(Temperature)) * GridResolution + ToCell(Moisture)];
+
+	if (Cell & AmbiguousFlag)
+	{
+		return ScanBounds(Height, Temperature, Moisture, Cell & ~AmbiguousFlag);
+	}
+
+	return Cell == NoMatchCell ? INDEX_NONE : Cell;
+}
+
+int32 FBiomeLookupTable::ScanBounds(float Height, float Temperature, float Moisture, int32 FirstSlot) const
+{
+	for (int32 Slot = FirstSlot; Slot < Bounds.Num(); Slot++)
+	{
+		const FBiomeBounds& B = Bounds[Slot];
+		if (Height >= B.MinHeight && Height <= B.MaxHeight &&
+			Temperature >= B.MinTemperature && Temperature <= B.MaxTemperature &&
+			Moisture >= B.MinMoisture && Moisture <= B.MaxMoisture)
+		{
+			return Slot;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+EBiomeType FBiomeLookupTable::GetBiomeType(int32 Slot) const
+{
+	return SlotTypes.IsValidIndex(Slot) ? SlotTypes[Slot] : EBiomeType::Plains;
+}
+
+const FLinearColor& FBiomeLookupTable::GetColor(int32 Slot) const
+{
+	return SlotColors.IsValidIndex(Slot) ? SlotColors[Slot] : SlotColors.Last();
+}
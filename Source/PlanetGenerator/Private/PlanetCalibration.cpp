@@ -0,0 +1,166 @@
+#include "PlanetCalibration.h"
+#include "PlanetActor.h"
+#include "PlanetMeshBuilder.h"
+#include "PlanetGeneratorSettings.h"
+#include "Async/Async.h"
+
+// Octave counts of the two reference builds the per-octave cost is fitted from
+static constexpr int32 LowOctaves = 1;
+static constexpr int32 HighOctaves = 6;
+
+// Vertices of the subdivided icosahedron at a resolution
+static double GetIcosphereVertices(int32 Resolution)
+{
+	return 10.0 * FMath::Pow(4.0, (double)Resolution) + 2.0;
+}
+
+// Fastest of a few builds, so a context switch does not count against the machine
+static double MeasureBuildMs(const FPlanetBuildSettings& Settings, int32& OutNumVertices)
+{
+	double BestMs = TNumericLimits<double>::Max();
+	for (int32 Run = 0; Run < 3; Run++)
+	{
+		FPlanetBuildResult Result;
+		FPlanetMeshBuilder(Settings).Build(Result);
+		BestMs = FMath::Min(BestMs, (double)Result.Stats.BuildMs);
+		OutNumVertices = Result.Stats.NumVertices;
+	}
+	return BestMs;
+}
+
+// Costs fitted from the reference builds
+struct FPlanetBuildCosts
+{
+	float MicrosecondsPerVertex = 0.0f;
+	float MicrosecondsPerOctave = 0.0f;
+	int32 NumLayers = 1;
+	int32 ReferenceOctaves = 1;
+};
+
+// Builds the reference planet at two octave counts; safe on any thread
+static FPlanetBuildCosts MeasureBuildCosts(const FPlanetBuildSettings& Reference)
+{
+	auto MeasureWithOctaves = [&Reference](int32 Octaves, int32& OutNumVertices)
+	{
+		FPlanetBuildSettings BuildSettings = Reference;
+		for (FNoiseLayer& Layer : BuildSettings.NoiseLayers)
+		{
+			Layer.NumLayers = Octaves;
+		}
+		return MeasureBuildMs(BuildSettings, OutNumVertices);
+	};
+
+	// Warm up lazily built tables before timing
+	int32 NumVertices = 0;
+	{
+		FPlanetBuildResult WarmUp;
+		FPlanetMeshBuilder(Reference).Build(WarmUp);
+	}
+
+	const double LowMs = MeasureWithOctaves(LowOctaves, NumVertices);
+	const double HighMs = MeasureWithOctaves(HighOctaves, NumVertices);
+
+	// Build time is close to linear in vertices and in octaves per vertex
+	FPlanetBuildCosts Costs;
+	Costs.NumLayers = Reference.NoiseLayers.Num();
+	Costs.ReferenceOctaves = FMath::Max(Reference.NoiseLayers[0].NumLayers, 1);
+
+	const double OctaveSamples = (double)NumVertices * Costs.NumLayers;
+	Costs.MicrosecondsPerOctave = (float)FMath::Max((HighMs - LowMs) * 1000.0 / (OctaveSamples * (HighOctaves - LowOctaves)), 0.0);
+	Costs.MicrosecondsPerVertex = (float)FMath::Max((LowMs * 1000.0 - Costs.MicrosecondsPerOctave * OctaveSamples * LowOctaves) / NumVertices, 0.0);
+	return Costs;
+}
+
+// Set while a measurement is in flight; only touched on the game thread
+static bool bCalibrationRunning = false;
+
+void UPlanetCalibration::EnsureCalibrated(bool bForce)
+{
+	check(IsInGameThread());
+
+	const UPlanetGeneratorSettings* Settings = GetDefault<UPlanetGeneratorSettings>();
+	const UPlanetCalibration* Calibration = GetDefault<UPlanetCalibration>();
+
+	const bool bStale = Calibration->MaxResolution == INDEX_NONE
+		|| Calibration->CalibratedCores != FPlatformMisc::NumberOfCoresIncludingHyperthreads()
+		|| Calibration->CalibratedTargetMs != Settings->TargetGenerationMs;
+	if (bCalibrationRunning || !(bForce || bStale))
+	{
+		return;
+	}
+
+	// The default planet, without the optional bakes, stands in for a typical one. The snapshot
+	// is taken here because the actor defaults may only be read on the game thread.
+	FPlanetBuildSettings Reference = GetDefault<APlanetActor>()->MakeBuildSettings();
+	Reference.Resolution = Settings->CalibrationResolution;
+	Reference.BakeSurfaceTextures = false;
+	Reference.ImpostorResolution = 0;
+	if (Reference.NoiseLayers.Num() == 0)
+	{
+		Reference.NoiseLayers.AddDefaulted();
+	}
+
+	bCalibrationRunning = true;
+	Async(EAsyncExecution::ThreadPool, [Reference]()
+	{
+		const FPlanetBuildCosts Costs = MeasureBuildCosts(Reference);
+		AsyncTask(ENamedThreads::GameThread, [Costs]()
+		{
+			bCalibrationRunning = false;
+			GetMutableDefault<UPlanetCalibration>()->ApplyCosts(Costs.MicrosecondsPerVertex, Costs.MicrosecondsPerOctave, Costs.NumLayers, Costs.ReferenceOctaves);
+		});
+	});
+}
+
+bool UPlanetCalibration::IsCalibrating()
+{
+	return bCalibrationRunning;
+}
+
+bool UPlanetCalibration::IsActive()
+{
+	return GetDefault<UPlanetGeneratorSettings>()->bAutoCalibrate && GetDefault<UPlanetCalibration>()->MaxResolution != INDEX_NONE;
+}
+
+float UPlanetCalibration::PredictBuildMs(int32 Resolution, int32 Octaves, int32 NumLayers) const
+{
+	const double Microseconds = GetIcosphereVertices(Resolution) * (MicrosecondsPerVertex + MicrosecondsPerOctave * Octaves * NumLayers);
+	return (float)(Microseconds / 1000.0);
+}
+
+void UPlanetCalibration::ApplyCosts(float InMicrosecondsPerVertex, float InMicrosecondsPerOctave, int32 NumLayers, int32 ReferenceOctaves)
+{
+	const UPlanetGeneratorSettings* Settings = GetDefault<UPlanetGeneratorSettings>();
+
+	MicrosecondsPerVertex = InMicrosecondsPerVertex;
+	MicrosecondsPerOctave = InMicrosecondsPerOctave;
+
+	// Highest resolution that meets the target at the reference octave count, then the most octaves there
+	MaxResolution = 0;
+	for (int32 Resolution = Settings->MaxCalibratedResolution; Resolution > 0; Resolution--)
+	{
+		if (PredictBuildMs(Resolution, ReferenceOctaves, NumLayers) <= Settings->TargetGenerationMs)
+		{
+			MaxResolution = Resolution;
+			break;
+		}
+	}
+
+	MaxOctaves = 1;
+	for (int32 Octaves = Settings->MaxCalibratedOctaves; Octaves > 1; Octaves--)
+	{
+		if (PredictBuildMs(MaxResolution, Octaves, NumLayers) <= Settings->TargetGenerationMs)
+		{
+			MaxOctaves = Octaves;
+			break;
+		}
+	}
+
+	CalibratedCores = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+	CalibratedTargetMs = Settings->TargetGenerationMs;
+	SaveConfig();
+
+	UE_LOG(LogTemp, Display, TEXT("PlanetCalibration: %.3f us/vertex, %.3f us/octave sample on %d cores; resolution %d and %d octaves meet %.0f ms (predicted %.1f ms)"),
+		MicrosecondsPerVertex, MicrosecondsPerOctave, CalibratedCores, MaxResolution, MaxOctaves, CalibratedTargetMs,
+		PredictBuildMs(MaxResolution, MaxOctaves, NumLayers));
+}
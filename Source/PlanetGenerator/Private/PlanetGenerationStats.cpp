@@ -0,0 +1,20 @@
+#include "PlanetGenerationStats.h"
+
+DEFINE_STAT(STAT_PlanetBuild);
+DEFINE_STAT(STAT_PlanetSubdivision);
+DEFINE_STAT(STAT_PlanetReorder);
+DEFINE_STAT(STAT_PlanetTopology);
+DEFINE_STAT(STAT_PlanetNoise);
+DEFINE_STAT(STAT_PlanetClimate);
+DEFINE_STAT(STAT_PlanetBiomes);
+DEFINE_STAT(STAT_PlanetTangents);
+DEFINE_STAT(STAT_PlanetOcean);
+DEFINE_STAT(STAT_PlanetCollision);
+DEFINE_STAT(STAT_PlanetBake);
+DEFINE_STAT(STAT_PlanetCollisionSetup);
+DEFINE_STAT(STAT_PlanetUpload);
+DEFINE_STAT(STAT_PlanetApply);
+DEFINE_STAT(STAT_PlanetTileSelection);
+DEFINE_STAT(STAT_PlanetVertices);
+DEFINE_STAT(STAT_PlanetTriangles);
+DEFINE_STAT(STAT_PlanetGeometryMemory);
@@ -2,6 +2,14 @@
 #include "Kismet/GameplayStatics.h"
 
 APlanetActor* UPlanetGeneratorBlueprintFunctionLibrary::CreatePlanet(UObject* WorldContextObject, FVector Location, FRotator Rotation, float Radius, int32 Resolution)
+{
+	FPlanetGenerationParams Params;
+	Params.PlanetRadius = Radius;
+	Params.Resolution = Resolution;
+	return CreatePlanetWithParams(WorldContextObject, Location, Rotation, Params);
+}
+
+APlanetActor* UPlanetGeneratorBlueprintFunctionLibrary::CreatePlanetWithParams(UObject* WorldContextObject, FVector Location, FRotator Rotation, const FPlanetGenerationParams& Params)
 {
 	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
 	if (!World)
@@ -9,27 +17,28 @@ APlanetActor* UPlanetGeneratorBlueprintFunctionLibrary::CreatePlanet(UObject* Wo
 		return nullptr;
 	}
 	
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	// Deferred so the parameters are in place before OnConstruction generates
+	const FTransform SpawnTransform(Rotation, Location);
+	APlanetActor* Planet = World->SpawnActorDeferred<APlanetActor>(APlanetActor::StaticClass(), SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+	if (!Planet)
+	{
+		return nullptr;
+	}
 	
-	APlanetActor* Planet = World->SpawnActor<APlanetActor>(APlanetActor::StaticClass(), Location, Rotation, SpawnParams);
-	if (Planet)
+	Planet->ApplyGenerationParams(Params);
+	Planet->FinishSpawning(SpawnTransform);
+	
+	// Without AutoUpdate, OnConstruction leaves generation to us
+	if (!Planet->AutoUpdate)
 	{
-		Planet->PlanetRadius = Radius;
-		Planet->Resolution = Resolution;
-		Planet->GeneratePlanet();
+		Planet->RequestGeneration();
 	}
 	
 	return Planet;
 }
 
-void UPlanetGeneratorBlueprintFunctionLibrary::AddNoiseLayer(APlanetActor* Planet, float Strength, int32 NumLayers, float BaseRoughness, float Roughness, float Persistence)
+FNoiseLayer UPlanetGeneratorBlueprintFunctionLibrary::MakeNoiseLayer(float Strength, int32 NumLayers, float BaseRoughness, float Roughness, float Persistence)
 {
-	if (!Planet)
-	{
-		return;
-	}
-	
 	FNoiseLayer NoiseLayer;
 	NoiseLayer.Enabled = true;
 	NoiseLayer.Strength = Strength;
@@ -37,9 +46,33 @@ void UPlanetGeneratorBlueprintFunctionLibrary::AddNoiseLayer(APlanetActor* Plane
 	NoiseLayer.BaseRoughness = BaseRoughness;
 	NoiseLayer.Roughness = Roughness;
 	NoiseLayer.Persistence = Persistence;
-	NoiseLayer.Center = FVector(FMath::FRand() * 2.0f - 1.0f, FMath::FRand() * 2.0f - 1.0f, FMath::FRand() * 2.0f - 1.0f) * 100.0f;
+	// No random Center: the planet's Seed gives each layer its own offset, so output stays reproducible
+	return NoiseLayer;
+}
+
+FBiomeSettings UPlanetGeneratorBlueprintFunctionLibrary::MakeBiome(EBiomeType BiomeType, FLinearColor BiomeColor, float MinHeight, float MaxHeight, float MinTemperature, float MaxTemperature, float MinMoisture, float MaxMoisture)
+{
+	FBiomeSettings Biome;
+	Biome.BiomeType = BiomeType;
+	Biome.BiomeColor = BiomeColor;
+	Biome.MinHeight = MinHeight;
+	Biome.MaxHeight = MaxHeight;
+	Biome.MinTemperature = MinTemperature;
+	Biome.MaxTemperature = MaxTemperature;
+	Biome.MinMoisture = MinMoisture;
+	Biome.MaxMoisture = MaxMoisture;
+	return Biome;
+}
+
+void UPlanetGeneratorBlueprintFunctionLibrary::AddNoiseLayer(APlanetActor* Planet, float Strength, int32 NumLayers, float BaseRoughness, float Roughness, float Persistence)
+{
+	if (!Planet)
+	{
+		return;
+	}
 	
-	Planet->NoiseLayers.Add(NoiseLayer);
+	Planet->NoiseLayers.Add(MakeNoiseLayer(Strength, NumLayers, BaseRoughness, Roughness, Persistence));
+	Planet->MarkGenerationDirty();
 }
 
 void UPlanetGeneratorBlueprintFunctionLibrary::SetClimateParameters(APlanetActor* Planet, float EquatorTemperature, float PoleTemperature, float MoistureScale)
@@ -52,6 +85,7 @@ void UPlanetGeneratorBlueprintFunctionLibrary::SetClimateParameters(APlanetActor
 	Planet->EquatorTemperature = EquatorTemperature;
 	Planet->PoleTemperature = PoleTemperature;
 	Planet->MoistureScale = MoistureScale;
+	Planet->MarkGenerationDirty();
 }
 
 void UPlanetGeneratorBlueprintFunctionLibrary::AddBiome(APlanetActor* Planet, EBiomeType BiomeType, FLinearColor BiomeColor, float MinHeight, float MaxHeight, float MinTemperature, float MaxTemperature, float MinMoisture, float MaxMoisture)
@@ -61,35 +95,23 @@ void UPlanetGeneratorBlueprintFunctionLibrary::AddBiome(APlanetActor* Planet, EB
 		return;
 	}
 	
-	// Check if biome already exists
+	const FBiomeSettings NewBiome = MakeBiome(BiomeType, BiomeColor, MinHeight, MaxHeight, MinTemperature, MaxTemperature, MinMoisture, MaxMoisture);
+	
+	// Update the biome if it already exists, keeping its material
 	for (FBiomeSettings& Biome : Planet->Biomes)
 	{
 		if (Biome.BiomeType == BiomeType)
 		{
-			// Update existing biome
-			Biome.BiomeColor = BiomeColor;
-			Biome.MinHeight = MinHeight;
-			Biome.MaxHeight = MaxHeight;
-			Biome.MinTemperature = MinTemperature;
-			Biome.MaxTemperature = MaxTemperature;
-			Biome.MinMoisture = MinMoisture;
-			Biome.MaxMoisture = MaxMoisture;
+			UMaterialInterface* BiomeMaterial = Biome.BiomeMaterial;
+			Biome = NewBiome;
+			Biome.BiomeMaterial = BiomeMaterial;
+			Planet->MarkGenerationDirty();
 			return;
 		}
 	}
 	
-	// Add new biome
-	FBiomeSettings NewBiome;
-	NewBiome.BiomeType = BiomeType;
-	NewBiome.BiomeColor = BiomeColor;
-	NewBiome.MinHeight = MinHeight;
-	NewBiome.MaxHeight = MaxHeight;
-	NewBiome.MinTemperature = MinTemperature;
-	NewBiome.MaxTemperature = MaxTemperature;
-	NewBiome.MinMoisture = MinMoisture;
-	NewBiome.MaxMoisture = MaxMoisture;
-	
 	Planet->Biomes.Add(NewBiome);
+	Planet->MarkGenerationDirty();
 }
 
 void UPlanetGeneratorBlueprintFunctionLibrary::RegeneratePlanet(APlanetActor* Planet)
@@ -1,26 +1,11 @@
 #include "PlanetGeneratorBlueprintLibrary.h"
+#include "PlanetGeneratorBlueprintFunctionLibrary.h"
 #include "Kismet/GameplayStatics.h"
 
 APlanetActor* UPlanetGeneratorBlueprintLibrary::SpawnPlanetActor(UObject* WorldContextObject, FVector Location, FRotator Rotation, float Radius, int32 Resolution)
 {
-	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
-	if (!World)
-	{
-		return nullptr;
-	}
-	
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-	
-	APlanetActor* Planet = World->SpawnActor<APlanetActor>(APlanetActor::StaticClass(), Location, Rotation, SpawnParams);
-	if (Planet)
-	{
-		Planet->PlanetRadius = Radius;
-		Planet->Resolution = Resolution;
-		Planet->GeneratePlanet();
-	}
-	
-	return Planet;
+	// Same single-generation deferred spawn as CreatePlanet
+	return UPlanetGeneratorBlueprintFunctionLibrary::CreatePlanet(WorldContextObject, Location, Rotation, Radius, Resolution);
 }
 
 void UPlanetGeneratorBlueprintLibrary::SetPlanetNoiseParameters(APlanetActor* PlanetActor, int32 NoiseLayerIndex, float Strength, int32 NumLayers, float BaseRoughness, float Roughness, float Persistence)
@@ -36,6 +21,7 @@ void UPlanetGeneratorBlueprintLibrary::SetPlanetNoiseParameters(APlanetActor* Pl
 	NoiseLayer.BaseRoughness = BaseRoughness;
 	NoiseLayer.Roughness = Roughness;
 	NoiseLayer.Persistence = Persistence;
+	PlanetActor->MarkGenerationDirty();
 }
 
 void UPlanetGeneratorBlueprintLibrary::SetPlanetBiomeParameters(APlanetActor* PlanetActor, EBiomeType BiomeType, FLinearColor BiomeColor, float MinHeight, float MaxHeight, float MinTemperature, float MaxTemperature, float MinMoisture, float MaxMoisture)
@@ -79,6 +65,8 @@ void UPlanetGeneratorBlueprintLibrary::SetPlanetBiomeParameters(APlanetActor* Pl
 		NewBiome.MaxMoisture = MaxMoisture;
 		PlanetActor->Biomes.Add(NewBiome);
 	}
+
+	PlanetActor->MarkGenerationDirty();
 }
 
 void UPlanetGeneratorBlueprintLibrary::SetPlanetClimateParameters(APlanetActor* PlanetActor, float EquatorTemperature, float PoleTemperature, float MoistureScale)
@@ -91,6 +79,7 @@ void UPlanetGeneratorBlueprintLibrary::SetPlanetClimateParameters(APlanetActor*
 	PlanetActor->EquatorTemperature = EquatorTemperature;
 	PlanetActor->PoleTemperature = PoleTemperature;
 	PlanetActor->MoistureScale = MoistureScale;
+	PlanetActor->MarkGenerationDirty();
 }
 
 void UPlanetGeneratorBlueprintLibrary::RegeneratePlanet(APlanetActor* PlanetActor)
@@ -1,7 +1,6 @@
 #include "PlanetGeneratorExample.h"
 #include "PlanetGeneratorBlueprintFunctionLibrary.h"
 #include "PlanetMaterialGenerator.h"
-#include "SimplexNoiseBPLibrary.h"
 
 APlanetGeneratorExample::APlanetGeneratorExample()
 {
@@ -32,141 +31,128 @@ void APlanetGeneratorExample::GeneratePlanet()
 		Planet = nullptr;
 	}
 
-	// Set the noise seed
-	USimplexNoiseBPLibrary::SetNoiseSeed(Seed);
+	// Collect every setting first so the planet generates once, when it spawns
+	FPlanetGenerationParams Params;
+	Params.PlanetRadius = PlanetRadius;
+	Params.Resolution = Resolution;
+	Params.Seed = Seed;
+
+	// Set climate parameters
+	Params.EquatorTemperature = EquatorTemperature;
+	Params.PoleTemperature = PoleTemperature;
+	Params.MoistureScale = MoistureScale;
+
+	// Add noise layers on top of the planet's default layer; the params replace the whole list
+	Params.NoiseLayers = GetDefault<APlanetActor>()->NoiseLayers;
+	Params.NoiseLayers.Add(UPlanetGeneratorBlueprintFunctionLibrary::MakeNoiseLayer(1.0f, 4, 1.0f, 2.0f, 0.5f));
+	Params.NoiseLayers.Add(UPlanetGeneratorBlueprintFunctionLibrary::MakeNoiseLayer(0.5f, 6, 2.0f, 2.0f, 0.5f));
+	Params.NoiseLayers.Add(UPlanetGeneratorBlueprintFunctionLibrary::MakeNoiseLayer(0.25f, 2, 4.0f, 2.0f, 0.5f));
+
+	// Set ocean parameters with the ocean material
+	Params.HasOcean = HasOcean;
+	Params.OceanLevel = OceanLevel;
+	Params.OceanMaterial = UPlanetMaterialGenerator::CreateOceanMaterial(
+		this,
+		FLinearColor(0.0f, 0.3f, 0.6f, 0.7f), // Water color
+		0.2f,  // Roughness
+		0.1f,  // Metallic
+		0.7f,  // Opacity
+		true   // Two-sided
+	);
+
+	// Set planet material
+	Params.PlanetMaterial = UPlanetMaterialGenerator::CreatePlanetMaterial(
+		this,
+		FLinearColor(0.2f, 0.5f, 0.2f, 1.0f), // Base color
+		0.8f,  // Roughness
+		0.0f,  // Metallic
+		true,  // Two-sided
+		0.5f,  // Ambient occlusion
+		0.0f   // Emissive strength
+	);
+
+	// Add biomes with custom materials
+	AddDefaultBiomes(Params);
 
-	// Create the planet
-	Planet = UPlanetGeneratorBlueprintFunctionLibrary::CreatePlanet(this, GetActorLocation(), GetActorRotation(), PlanetRadius, Resolution);
+	// Collide against a coarse copy of the terrain rather than the render mesh
+	Params.CollisionMode = EPlanetCollisionMode::LowResolution;
 
+	// Create the planet; it generates once with all the settings
+	Planet = UPlanetGeneratorBlueprintFunctionLibrary::CreatePlanetWithParams(this, GetActorLocation(), GetActorRotation(), Params);
+
+	// This will enable auto-rotation and tile selection for the example planet
 	if (Planet)
 	{
-		// Set climate parameters
-		UPlanetGeneratorBlueprintFunctionLibrary::SetClimateParameters(Planet, EquatorTemperature, PoleTemperature, MoistureScale);
-
-		// Add noise layers
-		UPlanetGeneratorBlueprintFunctionLibrary::AddNoiseLayer(Planet, 1.0f, 4, 1.0f, 2.0f, 0.5f);
-		UPlanetGeneratorBlueprintFunctionLibrary::AddNoiseLayer(Planet, 0.5f, 6, 2.0f, 2.0f, 0.5f);
-		UPlanetGeneratorBlueprintFunctionLibrary::AddNoiseLayer(Planet, 0.25f, 2, 4.0f, 2.0f, 0.5f);
-
-		// Set ocean parameters with the ocean material
-		UMaterialInstanceDynamic* OceanMaterial = UPlanetMaterialGenerator::CreateOceanMaterial(
-			this,
-			FLinearColor(0.0f, 0.3f, 0.6f, 0.7f), // Water color
-			0.2f,  // Roughness
-			0.1f,  // Metallic
-			0.7f,  // Opacity
-			true   // Two-sided
-		);
-
-		// Set planet material
-		UMaterialInstanceDynamic* PlanetMaterial = UPlanetMaterialGenerator::CreatePlanetMaterial(
-			this,
-			FLinearColor(0.2f, 0.5f, 0.2f, 1.0f), // Base color
-			0.8f,  // Roughness
-			0.0f,  // Metallic
-			true,  // Two-sided
-			0.5f,  // Ambient occlusion
-			0.0f   // Emissive strength
-		);
-		Planet->PlanetMaterial = PlanetMaterial;
-
-		// Add biomes with custom materials
-		AddDefaultBiomes();
-
-		// This will enable auto-rotation and tile selection for the example planet
-		if (Planet)
-		{
-			// Set auto-rotation
-			Planet->AutoRotate = true;
-			Planet->RotationSpeed = 2.0f;
-			Planet->RotationAxis = FVector(0.0f, 0.0f, 1.0f);
-
-			// Enable tile selection
-			Planet->EnableTileSelection = true;
-			Planet->SelectedTileColor = FLinearColor(1.0f, 0.3f, 0.3f, 1.0f);
-			Planet->SelectedTileHighlightIntensity = 1.5f;
-		}
-
-		// Regenerate the planet with all the settings
-		UPlanetGeneratorBlueprintFunctionLibrary::RegeneratePlanet(Planet);
-
-		// Make sure the planet has collision enabled
-		if (Planet && Planet->PlanetMesh)
-		{
-			Planet->PlanetMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-			Planet->PlanetMesh->SetCollisionResponseToAllChannels(ECR_Block);
-		}
+		// Set auto-rotation
+		Planet->AutoRotate = true;
+		Planet->RotationSpeed = 2.0f;
+		Planet->RotationAxis = FVector(0.0f, 0.0f, 1.0f);
+
+		// Enable tile selection
+		Planet->EnableTileSelection = true;
+		Planet->SelectedTileColor = FLinearColor(1.0f, 0.3f, 0.3f, 1.0f);
+		Planet->SelectedTileHighlightIntensity = 1.5f;
+
+		// Hand the new rotation settings to the planet subsystem
+		Planet->RefreshMotion();
 	}
 }
 
-void APlanetGeneratorExample::AddDefaultBiomes()
+void APlanetGeneratorExample::AddDefaultBiomes(FPlanetGenerationParams& Params)
 {
-	if (!Planet)
-	{
-		return;
-	}
-
 	// Ocean biome
-	UPlanetGeneratorBlueprintFunctionLibrary::AddBiome(
-		Planet,
+	Params.Biomes.Add(UPlanetGeneratorBlueprintFunctionLibrary::MakeBiome(
 		EBiomeType::Ocean,
 		FLinearColor(0.0f, 0.1f, 0.4f, 1.0f),
 		0.0f, 0.3f, 0.0f, 1.0f, 0.0f, 1.0f
-	);
+	));
 
 	// Beach biome
-	UPlanetGeneratorBlueprintFunctionLibrary::AddBiome(
-		Planet,
+	Params.Biomes.Add(UPlanetGeneratorBlueprintFunctionLibrary::MakeBiome(
 		EBiomeType::Beach,
 		FLinearColor(0.95f, 0.95f, 0.8f, 1.0f),
 		0.3f, 0.35f, 0.0f, 1.0f, 0.0f, 1.0f
-	);
+	));
 
 	// Desert biome
-	UPlanetGeneratorBlueprintFunctionLibrary::AddBiome(
-		Planet,
+	Params.Biomes.Add(UPlanetGeneratorBlueprintFunctionLibrary::MakeBiome(
 		EBiomeType::Desert,
 		FLinearColor(0.85f, 0.8f, 0.5f, 1.0f),
 		0.35f, 0.6f, 0.6f, 1.0f, 0.0f, 0.3f
-	);
+	));
 
 	// Plains biome
-	UPlanetGeneratorBlueprintFunctionLibrary::AddBiome(
-		Planet,
+	Params.Biomes.Add(UPlanetGeneratorBlueprintFunctionLibrary::MakeBiome(
 		EBiomeType::Plains,
 		FLinearColor(0.2f, 0.6f, 0.2f, 1.0f),
 		0.35f, 0.6f, 0.3f, 0.7f, 0.3f, 0.6f
-	);
+	));
 
 	// Forest biome
-	UPlanetGeneratorBlueprintFunctionLibrary::AddBiome(
-		Planet,
+	Params.Biomes.Add(UPlanetGeneratorBlueprintFunctionLibrary::MakeBiome(
 		EBiomeType::Forest,
 		FLinearColor(0.1f, 0.4f, 0.1f, 1.0f),
 		0.4f, 0.7f, 0.3f, 0.7f, 0.6f, 1.0f
-	);
+	));
 
 	// Mountains biome
-	UPlanetGeneratorBlueprintFunctionLibrary::AddBiome(
-		Planet,
+	Params.Biomes.Add(UPlanetGeneratorBlueprintFunctionLibrary::MakeBiome(
 		EBiomeType::Mountains,
 		FLinearColor(0.5f, 0.5f, 0.5f, 1.0f),
 		0.7f, 0.9f, 0.0f, 1.0f, 0.0f, 1.0f
-	);
+	));
 
 	// Snow capped biome
-	UPlanetGeneratorBlueprintFunctionLibrary::AddBiome(
-		Planet,
+	Params.Biomes.Add(UPlanetGeneratorBlueprintFunctionLibrary::MakeBiome(
 		EBiomeType::SnowCapped,
 		FLinearColor(0.95f, 0.95f, 0.95f, 1.0f),
 		0.9f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f
-	);
+	));
 
 	// Tundra biome
-	UPlanetGeneratorBlueprintFunctionLibrary::AddBiome(
-		Planet,
+	Params.Biomes.Add(UPlanetGeneratorBlueprintFunctionLibrary::MakeBiome(
 		EBiomeType::Tundra,
 		FLinearColor(0.8f, 0.8f, 0.9f, 1.0f),
 		0.35f, 0.7f, 0.0f, 0.3f, 0.0f, 1.0f
-	);
+	));
 }
@@ -0,0 +1,7 @@
+#include "PlanetGeneratorSettings.h"
+
+UPlanetGeneratorSettings::UPlanetGeneratorSettings()
+{
+	CategoryName = TEXT("Plugins");
+	SectionName = TEXT("Planet Generator");
+}
@@ -0,0 +1,64 @@
+#include "PlanetImpostor.h"
+#include "Async/ParallelFor.h"
+
+void FPlanetImpostorAtlas::Reset()
+{
+	Resolution = 0;
+	Albedo.Reset();
+}
+
+FVector2D FPlanetImpostorAtlas::OctahedralEncode(const FVector& Direction)
+{
+	const float L1 = FMath::Abs(Direction.X) + FMath::Abs(Direction.Y) + FMath::Abs(Direction.Z);
+	FVector2D Oct(Direction.X / L1, Direction.Y / L1);
+
+	if (Direction.Z < 0.0f)
+	{
+		Oct = FVector2D(
+			(1.0f - FMath::Abs(Oct.Y)) * (Oct.X >= 0.0f ? 1.0f : -1.0f),
+			(1.0f - FMath::Abs(Oct.X)) * (Oct.Y >= 0.0f ? 1.0f : -1.0f));
+	}
+
+	return Oct * 0.5f + FVector2D(0.5f, 0.5f);
+}
+
+FVector FPlanetImpostorAtlas::OctahedralDecode(const FVector2D& UV)
+{
+	const FVector2D Oct = UV * 2.0f - FVector2D(1.0f, 1.0f);
+	FVector Direction(Oct.X, Oct.Y, 1.0f - FMath::Abs(Oct.X) - FMath::Abs(Oct.Y));
+
+	const float Fold = FMath::Clamp(-Direction.Z, 0.0f, 1.0f);
+	Direction.X += Direction.X >= 0.0f ? -Fold : Fold;
+	Direction.Y += Direction.Y >= 0.0f ? -Fold : Fold;
+
+	return Direction.GetSafeNormal();
+}
+
+void FPlanetImpostorBaker::Bake(int32 Resolution,
+	TFunctionRef<float(const FVector&)> ElevationAt,
+	TFunctionRef<FLinearColor(const FVector&, float)> AlbedoAt,
+	FPlanetImpostorAtlas& OutAtlas)
+{
+	OutAtlas.Reset();
+	if (Resolution <= 0)
+	{
+		return;
+	}
+
+	OutAtlas.Resolution = Resolution;
+	OutAtlas.Albedo.SetNumUninitialized(Resolution * Resolution);
+
+	// One surface sample per texel centre
+	ParallelFor(Resolution, [&](int32 Y)
+	{
+		FColor* Row = &OutAtlas.Albedo[Y * Resolution];
+		for (int32 X = 0; X < Resolution; X++)
+		{
+			const FVector Direction = FPlanetImpostorAtlas::OctahedralDecode(FVector2D((X + 0.5f) / Resolution, (Y + 0.5f) / Resolution));
+			const float Elevation = ElevationAt(Direction);
+
+			Row[X] = AlbedoAt(Direction, Elevation).ToFColor(true);
+			Row[X].A = (uint8)FMath::RoundToInt(FMath::Clamp(Elevation, 0.0f, 1.0f) * 255.0f);
+		}
+	});
+}
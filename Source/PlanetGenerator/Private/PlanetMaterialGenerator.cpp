@@ -2,6 +2,7 @@
 #include "Materials/MaterialInstanceDynamic.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Engine/Engine.h"
+#include "Engine/Texture2D.h"
 #include <MaterialDomain.h>
 
 
@@ -13,17 +14,7 @@ UMaterialInstanceDynamic* UPlanetMaterialGenerator::CreatePlanetMaterial(UObject
                                                                         float AmbientOcclusion,
                                                                         float EmissiveStrength)
 {
-    // Load the base material from your project's content
-    UMaterial* BaseMaterial = LoadObject<UMaterial>(nullptr, TEXT("/PlanetGenerator/Materials/M_PlanetBase"));
-    
-    if (!BaseMaterial)
-    {
-        // Fallback to default material
-        UE_LOG(LogTemp, Warning, TEXT("M_PlanetBase material not found. Using default material instead."));
-        BaseMaterial = UMaterial::GetDefaultMaterial(EMaterialDomain::MD_Surface);
-    }
-    
-    UMaterialInstanceDynamic* MaterialInstance = UMaterialInstanceDynamic::Create(BaseMaterial, WorldContextObject);
+    UMaterialInstanceDynamic* MaterialInstance = UMaterialInstanceDynamic::Create(GetPlanetBaseMaterial(), WorldContextObject);
     
     if (MaterialInstance)
     {
@@ -51,6 +42,28 @@ UMaterialInstanceDynamic* UPlanetMaterialGenerator::CreatePlanetMaterial(UObject
     return MaterialInstance;
 }
 
+UMaterialInterface* UPlanetMaterialGenerator::GetPlanetBaseMaterial()
+{
+    // Load the base material from your project's content
+    UMaterial* BaseMaterial = LoadObject<UMaterial>(nullptr, TEXT("/PlanetGenerator/Materials/M_PlanetBase"));
+    
+    if (!BaseMaterial)
+    {
+        // Fallback to default material
+        UE_LOG(LogTemp, Warning, TEXT("M_PlanetBase material not found. Using default material instead."));
+        BaseMaterial = UMaterial::GetDefaultMaterial(EMaterialDomain::MD_Surface);
+    }
+
+    return BaseMaterial;
+}
+
+bool UPlanetMaterialGenerator::HasTextureParameter(const UMaterialInterface* Material, FName ParameterName)
+{
+    // Fails for parameters the material graph does not declare
+    UTexture* Value = nullptr;
+    return Material && Material->GetTextureParameterValue(FHashedMaterialParameterInfo(ParameterName), Value);
+}
+
 UMaterialInstanceDynamic* UPlanetMaterialGenerator::CreateOceanMaterial(UObject* WorldContextObject, 
                                                                        FLinearColor WaterColor, 
                                                                        float Roughness, 
@@ -91,6 +104,89 @@ UMaterialInstanceDynamic* UPlanetMaterialGenerator::CreateOceanMaterial(UObject*
     return MaterialInstance;
 }
 
+static void FillBiomePalette(FLinearColor* Data, const TArray<FLinearColor>& Colors, const TArray<FLinearColor>& SurfaceParameters)
+{
+    const int32 Width = UPlanetMaterialGenerator::BiomePaletteWidth;
+    for (int32 i = 0; i < Width; i++)
+    {
+        Data[i] = Colors.IsValidIndex(i) ? Colors[i] : FLinearColor::Black;
+        Data[Width + i] = SurfaceParameters.IsValidIndex(i) ? SurfaceParameters[i] : FLinearColor(0.8f, 0.0f, 0.5f, 0.0f);
+    }
+}
+
+UTexture2D* UPlanetMaterialGenerator::CreateBiomePaletteTexture(const TArray<FLinearColor>& Colors, const TArray<FLinearColor>& SurfaceParameters)
+{
+    UTexture2D* Texture = UTexture2D::CreateTransient(BiomePaletteWidth, 2, PF_A32B32G32R32F);
+    if (!Texture)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("CreateBiomePaletteTexture: Failed to create palette texture"));
+        return nullptr;
+    }
+
+    // Indices must be read back exactly, so no filtering and no sRGB conversion
+    Texture->Filter = TF_Nearest;
+    Texture->SRGB = false;
+    Texture->AddressX = TA_Clamp;
+    Texture->AddressY = TA_Clamp;
+
+    // Fill the only mip before the render resource exists
+    FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+    FLinearColor* Data = static_cast<FLinearColor*>(Mip.BulkData.Lock(LOCK_READ_WRITE));
+    FillBiomePalette(Data, Colors, SurfaceParameters);
+    Mip.BulkData.Unlock();
+
+    Texture->UpdateResource();
+    return Texture;
+}
+
+void UPlanetMaterialGenerator::UpdateBiomePaletteTexture(UTexture2D* PaletteTexture, const TArray<FLinearColor>& Colors, const TArray<FLinearColor>& SurfaceParameters)
+{
+    if (!PaletteTexture)
+    {
+        return;
+    }
+
+    // The render thread owns the upload buffer and frees it when done
+    FLinearColor* Data = new FLinearColor[BiomePaletteWidth * 2];
+    FillBiomePalette(Data, Colors, SurfaceParameters);
+
+    FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(0, 0, 0, 0, BiomePaletteWidth, 2);
+    PaletteTexture->UpdateTextureRegions(0, 1, Region, BiomePaletteWidth * sizeof(FLinearColor), sizeof(FLinearColor), reinterpret_cast<uint8*>(Data),
+        [](uint8* SrcData, const FUpdateTextureRegion2D* Regions)
+        {
+            delete[] reinterpret_cast<FLinearColor*>(SrcData);
+            delete Regions;
+        });
+}
+
+UTexture2D* UPlanetMaterialGenerator::CreateDataTexture(int32 Width, int32 Height, EPixelFormat Format, const void* Data, int32 BytesPerPixel, bool bSRGB)
+{
+    if (Width <= 0 || Height <= 0 || !Data)
+    {
+        return nullptr;
+    }
+
+    UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, Format);
+    if (!Texture)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("CreateDataTexture: Failed to create %dx%d texture"), Width, Height);
+        return nullptr;
+    }
+
+    // Cube faces meet at the atlas seams, so wrapping would bleed between faces
+    Texture->SRGB = bSRGB;
+    Texture->AddressX = TA_Clamp;
+    Texture->AddressY = TA_Clamp;
+
+    FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+    void* MipData = Mip.BulkData.Lock(LOCK_READ_WRITE);
+    FMemory::Memcpy(MipData, Data, (SIZE_T)Width * Height * BytesPerPixel);
+    Mip.BulkData.Unlock();
+
+    Texture->UpdateResource();
+    return Texture;
+}
+
 UMaterialInstanceDynamic* UPlanetMaterialGenerator::CreateBiomeMaterial(UObject* WorldContextObject, 
                                                                        FLinearColor BaseColor, 
                                                                        float Roughness, 
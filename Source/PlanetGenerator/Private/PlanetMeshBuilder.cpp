@@ -0,0 +1,1008 @@
+#include "PlanetMeshBuilder.h"
+#include "PlanetMeshOrder.h"
+#include "SimplexNoiseBPLibrary.h"
+#include "Misc/SecureHash.h"
+#include "Tasks/Task.h"
+#include "Tasks/Pipe.h"
+#include "Misc/MemStack.h"
+
+// Largest seeded offset of a noise layer on each axis, in noise space
+static constexpr float LayerOffsetRange = 100.0f;
+
+// Vertices per chunk of the per-vertex stages; small enough that a resolution 4 planet still
+// spreads over a few workers, large enough that task overhead stays negligible
+static constexpr int32 VerticesPerChunk = 1024;
+
+// Launches the build's tasks under FPlanetBuildSettings::MaxWorkers. Without a limit they go to the
+// scheduler as usual. With one worker they run inline, each on the thread that completes its last
+// prerequisite, which is always the building thread. Otherwise they are dealt round-robin to
+// MaxWorkers pipes, each of which runs one task at a time.
+class FPlanetBuildTasks
+{
+public:
+	explicit FPlanetBuildTasks(int32 MaxWorkers)
+		: bInline(MaxWorkers == 1)
+	{
+		for (int32 i = 0; MaxWorkers > 1 && i < MaxWorkers; i++)
+		{
+			Pipes.Add(MakeUnique<UE::Tasks::FPipe>(TEXT("PlanetBuild")));
+		}
+	}
+
+	template<typename TaskBodyType, typename PrerequisitesType>
+	UE::Tasks::FTask Launch(const TCHAR* DebugName, TaskBodyType&& TaskBody, PrerequisitesType&& Prerequisites)
+	{
+		if (Pipes.Num() > 0)
+		{
+			UE::Tasks::FPipe& Pipe = *Pipes[NextPipe];
+			NextPipe = (NextPipe + 1) % Pipes.Num();
+			return Pipe.Launch(DebugName, Forward<TaskBodyType>(TaskBody), Forward<PrerequisitesType>(Prerequisites));
+		}
+
+		return UE::Tasks::Launch(DebugName, Forward<TaskBodyType>(TaskBody), Forward<PrerequisitesType>(Prerequisites),
+			UE::Tasks::ETaskPriority::Normal, bInline ? UE::Tasks::EExtendedTaskPriority::Inline : UE::Tasks::EExtendedTaskPriority::None);
+	}
+
+	template<typename TaskBodyType>
+	UE::Tasks::FTask Launch(const TCHAR* DebugName, TaskBodyType&& TaskBody)
+	{
+		return Launch(DebugName, Forward<TaskBodyType>(TaskBody), TArray<UE::Tasks::FTask>());
+	}
+
+private:
+	TArray<TUniquePtr<UE::Tasks::FPipe>, TInlineAllocator<8>> Pipes;
+	int32 NextPipe = 0;
+	bool bInline = false;
+};
+
+// The object behind Shared when nothing else references it, so a recycled result rebuilds its
+// query structures in place and keeps their arrays' capacity; a new object otherwise
+template <typename ObjectType>
+static TSharedRef<ObjectType> ReuseOrMakeShared(TSharedPtr<const ObjectType>& Shared)
+{
+	TSharedPtr<ObjectType> Reused;
+	if (Shared.IsValid() && Shared.GetSharedReferenceCount() == 1)
+	{
+		Reused = ConstCastSharedPtr<ObjectType>(Shared);
+	}
+	Shared.Reset();
+
+	return Reused.IsValid() ? Reused.ToSharedRef() : MakeShared<ObjectType>();
+}
+
+FPlanetMeshBuilder::FPlanetMeshBuilder(const FPlanetBuildSettings& InSettings)
+	: Settings(InSettings)
+{
+	// Compile the biome list into a lookup table for this generation
+	BiomeLookup.Build(Settings.Biomes);
+
+	// Each layer gets its own stream, so adding a layer leaves the others where they were
+	LayerOffsets.SetNumUninitialized(Settings.NoiseLayers.Num());
+	for (int32 i = 0; i < LayerOffsets.Num(); i++)
+	{
+		FRandomStream Stream(HashCombine(GetTypeHash(Settings.Seed), GetTypeHash(i)));
+		LayerOffsets[i].X = Stream.FRandRange(-LayerOffsetRange, LayerOffsetRange);
+		LayerOffsets[i].Y = Stream.FRandRange(-LayerOffsetRange, LayerOffsetRange);
+		LayerOffsets[i].Z = Stream.FRandRange(-LayerOffsetRange, LayerOffsetRange);
+	}
+}
+
+void FPlanetMeshBuilder::Build(FPlanetBuildResult& OutResult) const
+{
+	FPlanetBuildResult& Result = OutResult;
+
+	// Taken before the reset drops them; a structure still referenced elsewhere is replaced.
+	// Dependents go first and let go of the graph and attributes so those can be reused too.
+	TSharedRef<FPlanetSurfaceSampler> NewSurfaceSampler = ReuseOrMakeShared(Result.SurfaceSampler);
+	NewSurfaceSampler->Reset();
+	TSharedRef<FPlanetPathfinder> NewPathfinder = ReuseOrMakeShared(Result.Pathfinder);
+	NewPathfinder->Reset();
+	TSharedRef<FPlanetSpatialIndex> NewSpatialIndex = ReuseOrMakeShared(Result.SpatialIndex);
+	NewSpatialIndex->Reset();
+	TSharedRef<FPlanetTileAttributes> NewAttributes = ReuseOrMakeShared(Result.Attributes);
+	TSharedRef<FPlanetTileGraph> NewTileGraph = ReuseOrMakeShared(Result.TileGraph);
+
+	Result.Reset();
+
+	FPlanetGenerationStats& Stats = Result.Stats;
+	PLANET_STAGE_SCOPE(Build, Stats.BuildMs);
+
+	// Temporaries that die with this build are bump allocated from the thread's memory stack
+	FMemMark ScratchMark(FMemStack::Get());
+
+	// Declared before the tasks it launches, so its pipes outlive them
+	FPlanetBuildTasks Tasks(Settings.MaxWorkers);
+
+	// Collision and the bakes sample the terrain functions directly, so they run beside the mesh
+	TArray<UE::Tasks::FTask, TInlineAllocator<2>> SideTasks;
+	if (Settings.CollisionMode == EPlanetCollisionMode::LowResolution)
+	{
+		SideTasks.Add(Tasks.Launch(UE_SOURCE_LOCATION, [this, &Result, &Stats]()
+		{
+			PLANET_STAGE_SCOPE(Collision, Stats.CollisionMs);
+			BuildLowResolutionCollision(Result);
+		}));
+	}
+
+	if (Settings.BakeSurfaceTextures || Settings.ImpostorResolution > 0)
+	{
+		SideTasks.Add(Tasks.Launch(UE_SOURCE_LOCATION, [this, &Result, &Stats]()
+		{
+			PLANET_STAGE_SCOPE(Bake, Stats.BakeMs);
+
+			if (Settings.BakeSurfaceTextures)
+			{
+				BakeSurface(Settings.BakeFaceResolution, Result.SurfaceBake);
+			}
+
+			if (Settings.ImpostorResolution > 0)
+			{
+				BakeImpostor(Settings.ImpostorResolution, Result.Impostor);
+			}
+		}));
+	}
+
+	{
+		PLANET_STAGE_SCOPE(Subdivision, Stats.SubdivisionMs);
+		CreateIcosphere(Result);
+		SubdivideIcosphere(Result, Settings.Resolution);
+	}
+
+	if (Settings.bOptimizeMeshOrder)
+	{
+		PLANET_STAGE_SCOPE(Reorder, Stats.ReorderMs);
+		OptimizeMeshOrder(Result);
+	}
+
+	const TArray<FVector>& Vertices = Result.UnitVertices;
+	const int32 NumVertices = Vertices.Num();
+
+	// Per-vertex climate is kept in the attribute store so gameplay reads match the mesh
+	NewAttributes->SetNumVertices(NumVertices);
+
+	Result.Positions.SetNum(NumVertices);
+	Result.Normals.SetNum(NumVertices);
+	Result.UV0.SetNum(NumVertices);
+	Result.VertexColors.SetNum(NumVertices);
+	Result.Tangents.SetNum(NumVertices);
+	Result.BiomeLookup = BiomeLookup;
+
+	FPlanetMeshStreams& Streams = Result.RenderStreams;
+	const bool bBuildRenderStreams = Settings.bBuildRenderStreams;
+	if (bBuildRenderStreams)
+	{
+		Streams.SetNum(NumVertices);
+	}
+
+	// Palette mode stores one slot per vertex; slots past the table fall back to baked colours
+	Result.bUsesBiomePalette = UsesBiomePalette();
+	if (Settings.ColorMode == EPlanetColorMode::BiomePalette && !Result.bUsesBiomePalette)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GeneratePlanet: %d biomes do not fit the biome palette, baking vertex colors instead"), Settings.Biomes.Num());
+	}
+
+	TArray<uint8, TMemStackAllocator<>> PaletteSlots;
+	if (Result.bUsesBiomePalette)
+	{
+		PaletteSlots.SetNumUninitialized(NumVertices);
+	}
+
+	// The topology only needs the subdivision, so it builds alongside the vertex stages
+	UE::Tasks::FTask TopologyTask = Tasks.Launch(UE_SOURCE_LOCATION, [&Result, &Vertices, &Stats, &NewTileGraph, &NewSpatialIndex]()
+	{
+		PLANET_STAGE_SCOPE(Topology, Stats.TopologyMs);
+
+		// Build tile and vertex adjacency from the subdivision by-products
+		NewTileGraph->Build(Vertices, Result.Triangles, Result.TriangleNeighbours);
+		Result.TileGraph = NewTileGraph;
+		NewSpatialIndex->Build(Result.TileGraph);
+		Result.SpatialIndex = NewSpatialIndex;
+	});
+
+	// Each chunk of vertices is its own small task graph: elevation and climate side by side, then
+	// biomes after both and tangents after elevation. Chunks overlap, so one chunk classifies biomes
+	// while the next is still sampling terrain noise. Stage times are kept per chunk and summed.
+	const int32 NumChunks = FMath::Max(FMath::DivideAndRoundUp(NumVertices, VerticesPerChunk), 1);
+	TArray<FPlanetGenerationStats, TMemStackAllocator<>> ChunkStats;
+	ChunkStats.SetNum(NumChunks);
+
+	FPlanetTileAttributes& Attributes = *NewAttributes;
+	TArray<UE::Tasks::FTask, TMemStackAllocator<>> ChunkTasks;
+	ChunkTasks.Reserve(NumChunks * 2 + 1);
+	for (int32 Chunk = 0; Chunk < NumChunks; Chunk++)
+	{
+		const int32 Begin = Chunk * VerticesPerChunk;
+		const int32 End = FMath::Min(Begin + VerticesPerChunk, NumVertices);
+		FPlanetGenerationStats& Times = ChunkStats[Chunk];
+
+		UE::Tasks::FTask Elevation = Tasks.Launch(UE_SOURCE_LOCATION, [this, &Result, &Vertices, &Attributes, &Times, Begin, End]()
+		{
+			PLANET_STAGE_SCOPE(Noise, Times.NoiseMs);
+
+			// Calculate final positions, normals and UVs
+			for (int32 i = Begin; i < End; i++)
+			{
+				FVector PointOnUnitSphere = Vertices[i].GetSafeNormal();
+				FVector PointOnPlanet = CalculatePointOnPlanet(PointOnUnitSphere);
+				Result.Positions[i] = PointOnPlanet;
+
+				// Normals point away from the planet centre, in planet local space like the positions
+				Result.Normals[i] = PointOnPlanet.GetSafeNormal();
+
+				// Calculate UV (simple spherical mapping)
+				float U = 0.5f + FMath::Atan2(PointOnUnitSphere.Y, PointOnUnitSphere.X) / (2.0f * PI);
+				float V = 0.5f - FMath::Asin(PointOnUnitSphere.Z) / PI;
+				Result.UV0[i] = FVector2D(U, V);
+
+				float Height = (PointOnPlanet.Size() - Settings.PlanetRadius) / (Settings.PlanetRadius * 0.2f);
+				Attributes.VertexHeights[i] = FMath::Clamp(Height, 0.0f, 1.0f);
+			}
+		});
+
+		UE::Tasks::FTask Climate = Tasks.Launch(UE_SOURCE_LOCATION, [this, &Vertices, &Attributes, &Times, Begin, End]()
+		{
+			PLANET_STAGE_SCOPE(Climate, Times.ClimateMs);
+
+			for (int32 i = Begin; i < End; i++)
+			{
+				FVector PointOnUnitSphere = Vertices[i].GetSafeNormal();
+				Attributes.VertexTemperatures[i] = GetTemperature(PointOnUnitSphere);
+				Attributes.VertexMoistures[i] = GetMoisture(PointOnUnitSphere);
+			}
+		});
+
+		ChunkTasks.Add(Tasks.Launch(UE_SOURCE_LOCATION, [this, &Result, &Attributes, &PaletteSlots, &Times, Begin, End]()
+		{
+			PLANET_STAGE_SCOPE(Biomes, Times.BiomeMs);
+
+			for (int32 i = Begin; i < End; i++)
+			{
+				const float Height = Attributes.VertexHeights[i];
+				const float Temperature = Attributes.VertexTemperatures[i];
+				const float Moisture = Attributes.VertexMoistures[i];
+
+				EBiomeType BiomeType;
+				if (BiomeLookup.IsBuilt())
+				{
+					// One table load gives the biome slot, which also carries its colour
+					int32 BiomeSlot = BiomeLookup.Classify(Height, Temperature, Moisture);
+					BiomeType = BiomeLookup.GetBiomeType(BiomeSlot);
+					Result.VertexColors[i] = BiomeLookup.GetColor(BiomeSlot);
+
+					// No match uses the entry after the last biome, like the table's colours
+					if (Result.bUsesBiomePalette)
+					{
+						PaletteSlots[i] = (uint8)(BiomeSlot == INDEX_NONE ? BiomeLookup.GetNumSlots() : BiomeSlot);
+					}
+				}
+				else
+				{
+					BiomeType = DetermineBiome(Height, Temperature, Moisture);
+					Result.VertexColors[i] = GetBiomeColor(BiomeType);
+				}
+
+				Attributes.VertexBiomes[i] = (uint8)BiomeType;
+			}
+		}, UE::Tasks::Prerequisites(Elevation, Climate)));
+
+		// Tangents only need the normals, so they run beside climate and biomes. The render streams
+		// are packed here too, while the chunk's positions and normals are still in cache.
+		ChunkTasks.Add(Tasks.Launch(UE_SOURCE_LOCATION, [&Result, &Streams, &Times, bBuildRenderStreams, Begin, End]()
+		{
+			PLANET_STAGE_SCOPE(Tangents, Times.TangentsMs);
+
+			for (int32 i = Begin; i < End; i++)
+			{
+				FVector Normal = Result.Normals[i];
+				FVector Tangent = FVector::CrossProduct(Normal, FVector::UpVector);
+				if (Tangent.SizeSquared() < SMALL_NUMBER)
+				{
+					Tangent = FVector::CrossProduct(Normal, FVector::ForwardVector);
+				}
+				Tangent.Normalize();
+				Result.Tangents[i] = FProcMeshTangent(Tangent, false);
+
+				// Same basis UProceduralMeshComponent would upload for an unflipped tangent
+				if (bBuildRenderStreams)
+				{
+					Streams.Positions[i] = FVector3f(Result.Positions[i]);
+					Streams.TangentBasis[i * 2] = FPackedNormal(FVector3f(Tangent));
+					Streams.TangentBasis[i * 2 + 1] = FPackedNormal(FVector4f(FVector3f(Normal), 1.0f));
+					Streams.TexCoords[i] = FVector2f(Result.UV0[i]);
+				}
+			}
+		}, Elevation));
+	}
+
+	// The palette encoding and everything after it query the tile graph
+	ChunkTasks.Add(TopologyTask);
+	UE::Tasks::Wait(ChunkTasks);
+	for (const FPlanetGenerationStats& Times : ChunkStats)
+	{
+		Stats.NoiseMs += Times.NoiseMs;
+		Stats.ClimateMs += Times.ClimateMs;
+		Stats.BiomeMs += Times.BiomeMs;
+		Stats.TangentsMs += Times.TangentsMs;
+	}
+
+	{
+		PLANET_STAGE_SCOPE(Biomes, Stats.BiomeMs);
+
+		// Classify each tile from the average of its corners
+		NewAttributes->BuildTiles(Result.Triangles, [this](float Height, float Temperature, float Moisture)
+		{
+			return (uint8)DetermineBiome(Height, Temperature, Moisture);
+		});
+		Result.Attributes = NewAttributes;
+
+		if (Result.bUsesBiomePalette)
+		{
+			EncodeBiomePalette(PaletteSlots, Result);
+		}
+
+		// Colours are final only after the palette encoding; converted without sRGB like the procedural mesh does
+		if (bBuildRenderStreams)
+		{
+			for (int32 i = 0; i < NumVertices; i++)
+			{
+				Streams.Colors[i] = Result.VertexColors[i].ToFColor(false);
+			}
+		}
+
+		NewPathfinder->Build(Result.TileGraph, Result.Attributes, Settings.PlanetRadius);
+		Result.Pathfinder = NewPathfinder;
+	}
+
+	{
+		PLANET_STAGE_SCOPE(Ocean, Stats.OceanMs);
+
+		// Terrain triangles left above the ocean
+		CullSubmergedTriangles(Result);
+	}
+
+	if (Result.RenderTriangles.Num() == 0)
+	{
+		Result.IndexBufferKey = Settings.Resolution * 2 + (Settings.bOptimizeMeshOrder ? 1 : 0);
+	}
+
+	NewSurfaceSampler->Build(Result.Positions, Result.Triangles, Result.TileGraph, Result.SpatialIndex, Result.Attributes);
+	Result.SurfaceSampler = NewSurfaceSampler;
+
+	UE::Tasks::Wait(SideTasks);
+
+	Stats.Resolution = Settings.Resolution;
+	Stats.NumVertices = NumVertices;
+	Stats.NumTriangles = Result.Triangles.Num() / 3;
+	Stats.BytesAllocated = (int64)Result.GetAllocatedSize();
+
+	if (Settings.bComputeOutputHash)
+	{
+		Result.OutputHash = Result.ComputeOutputHash();
+	}
+}
+
+FString FPlanetBuildResult::ComputeOutputHash() const
+{
+	FSHA1 Hash;
+	Hash.Update((const uint8*)Positions.GetData(), Positions.Num() * Positions.GetTypeSize());
+	Hash.Update((const uint8*)VertexColors.GetData(), VertexColors.Num() * VertexColors.GetTypeSize());
+	if (Attributes.IsValid())
+	{
+		Hash.Update(Attributes->VertexBiomes.GetData(), Attributes->VertexBiomes.Num());
+		Hash.Update(Attributes->TileBiomes.GetData(), Attributes->TileBiomes.Num());
+	}
+	Hash.Final();
+
+	uint8 Digest[FSHA1::DigestSize];
+	Hash.GetHash(Digest);
+	return BytesToHex(Digest, FSHA1::DigestSize);
+}
+
+void FPlanetBuildResult::Reset()
+{
+	UnitVertices.Reset();
+	Positions.Reset();
+	Triangles.Reset();
+	TriangleNeighbours.Reset();
+	RenderTriangles.Reset();
+	Normals.Reset();
+	UV0.Reset();
+	VertexColors.Reset();
+	Tangents.Reset();
+	RenderStreams.Reset();
+	IndexBufferKey = INDEX_NONE;
+	bUsesBiomePalette = false;
+
+	TileGraph.Reset();
+	SpatialIndex.Reset();
+	Attributes.Reset();
+	Pathfinder.Reset();
+	SurfaceSampler.Reset();
+	OceanShell.Reset();
+
+	CollisionVertices.Reset();
+	CollisionTriangles.Reset();
+	SurfaceBake.Reset();
+	Impostor.Reset();
+
+	Stats = FPlanetGenerationStats();
+	OutputHash.Reset();
+}
+
+SIZE_T FPlanetBuildResult::GetAllocatedSize() const
+{
+	SIZE_T Size = UnitVertices.GetAllocatedSize() + Positions.GetAllocatedSize() + Triangles.GetAllocatedSize()
+		+ TriangleNeighbours.GetAllocatedSize() + RenderTriangles.GetAllocatedSize() + Normals.GetAllocatedSize()
+		+ UV0.GetAllocatedSize() + VertexColors.GetAllocatedSize() + Tangents.GetAllocatedSize()
+		+ CollisionVertices.GetAllocatedSize() + CollisionTriangles.GetAllocatedSize()
+		+ SurfaceBake.Heights.GetAllocatedSize() + SurfaceBake.Albedo.GetAllocatedSize() + SurfaceBake.Normals.GetAllocatedSize()
+		+ Impostor.Albedo.GetAllocatedSize() + ScratchTriangles.GetAllocatedSize() + ScratchNeighbours.GetAllocatedSize()
+		+ ScratchMidpoints.GetAllocatedSize() + RenderStreams.GetAllocatedSize();
+
+	// Counted here too, since after ApplyBuildResult the result holds the structures it replaced
+	if (TileGraph.IsValid())
+	{
+		Size += TileGraph->GetAllocatedSize();
+	}
+	if (SpatialIndex.IsValid())
+	{
+		Size += SpatialIndex->GetAllocatedSize();
+	}
+	if (Attributes.IsValid())
+	{
+		Size += Attributes->GetAllocatedSize();
+	}
+	if (Pathfinder.IsValid())
+	{
+		Size += Pathfinder->GetAllocatedSize();
+	}
+	if (SurfaceSampler.IsValid())
+	{
+		Size += SurfaceSampler->GetAllocatedSize();
+	}
+
+	return Size;
+}
+
+void FPlanetMeshBuilder::EncodeBiomePalette(TArrayView<const uint8> PaletteSlots, FPlanetBuildResult& Result) const
+{
+	// Encode palette indices: R is the vertex slot, B the most common different slot around it
+	// and G how far towards that slot the material should blend
+	for (int32 i = 0; i < PaletteSlots.Num(); i++)
+	{
+		const uint8 Slot = PaletteSlots[i];
+		uint8 BlendSlot = Slot;
+		int32 BlendCount = 0;
+
+		TArrayView<const int32> Neighbours = Result.TileGraph->GetVertexNeighbours(i);
+		for (int32 a = 0; a < Neighbours.Num(); a++)
+		{
+			const uint8 Candidate = PaletteSlots[Neighbours[a]];
+			if (Candidate == Slot || Candidate == BlendSlot)
+			{
+				continue;
+			}
+
+			int32 Count = 0;
+			for (int32 b = a; b < Neighbours.Num(); b++)
+			{
+				Count += PaletteSlots[Neighbours[b]] == Candidate ? 1 : 0;
+			}
+
+			if (Count > BlendCount)
+			{
+				BlendSlot = Candidate;
+				BlendCount = Count;
+			}
+		}
+
+		// Half weight when every neighbour differs, so two sides of a border meet at the midpoint
+		const float BlendWeight = Neighbours.Num() > 0 ? 0.5f * BlendCount / Neighbours.Num() : 0.0f;
+		Result.VertexColors[i] = FLinearColor(Slot / 255.0f, BlendWeight, BlendSlot / 255.0f, 1.0f);
+	}
+}
+
+void FPlanetMeshBuilder::CullSubmergedTriangles(FPlanetBuildResult& Result) const
+{
+	// Left empty unless something is culled; see FPlanetBuildResult::RenderTriangles
+	Result.RenderTriangles.Reset();
+	if (!Settings.HasOcean)
+	{
+		return;
+	}
+
+	TSharedRef<const FPlanetOceanShell> Shell = FPlanetOceanShell::Get(Settings.OceanResolution);
+	Result.OceanShell = Shell;
+
+	// A triangle whose corners are all inside the shell's inscribed sphere is entirely under water,
+	// since the triangle lies within the convex hull of its corners
+	const float CullRadiusSquared = FMath::Square(GetOceanRadius() * Shell->InscribedRadius);
+	const TArray<FVector>& Positions = Result.Positions;
+	const TArray<int32>& Triangles = Result.Triangles;
+
+	Result.RenderTriangles.Reserve(Triangles.Num());
+	for (int32 i = 0; i < Triangles.Num(); i += 3)
+	{
+		const int32 Index1 = Triangles[i];
+		const int32 Index2 = Triangles[i + 1];
+		const int32 Index3 = Triangles[i + 2];
+		if (Positions[Index1].SizeSquared() < CullRadiusSquared &&
+			Positions[Index2].SizeSquared() < CullRadiusSquared &&
+			Positions[Index3].SizeSquared() < CullRadiusSquared)
+		{
+			continue;
+		}
+
+		Result.RenderTriangles.Add(Index1);
+		Result.RenderTriangles.Add(Index2);
+		Result.RenderTriangles.Add(Index3);
+	}
+
+	if (Result.RenderTriangles.Num() == Triangles.Num())
+	{
+		Result.RenderTriangles.Reset();
+	}
+}
+
+void FPlanetMeshBuilder::BuildLowResolutionCollision(FPlanetBuildResult& Result) const
+{
+	// Displace the shared unit icosphere with the same terrain function as the render mesh
+	TSharedRef<const FPlanetOceanShell> Sphere = FPlanetOceanShell::Get(FMath::Min(Settings.CollisionResolution, Settings.Resolution));
+
+	Result.CollisionVertices.SetNumUninitialized(Sphere->Positions.Num());
+	for (int32 i = 0; i < Sphere->Positions.Num(); i++)
+	{
+		Result.CollisionVertices[i] = CalculatePointOnPlanet(Sphere->Positions[i]);
+	}
+	Result.CollisionTriangles = Sphere->Triangles;
+}
+
+void FPlanetMeshBuilder::BakeSurface(int32 FaceResolution, FPlanetSurfaceBake& OutBake) const
+{
+	auto ElevationAt = [this](const FVector& Direction)
+	{
+		return EvaluateNoise(Direction);
+	};
+
+	auto AlbedoAt = [this](const FVector& Direction, float Elevation)
+	{
+		return GetSurfaceAlbedo(Direction, Elevation);
+	};
+
+	FPlanetSurfaceBaker::Bake(FaceResolution, 0.2f, ElevationAt, AlbedoAt, OutBake);
+}
+
+void FPlanetMeshBuilder::BakeImpostor(int32 Resolution, FPlanetImpostorAtlas& OutAtlas) const
+{
+	auto ElevationAt = [this](const FVector& Direction)
+	{
+		return EvaluateNoise(Direction);
+	};
+
+	// The impostor has no separate water shell, so the sea is painted into the atlas
+	auto AlbedoAt = [this](const FVector& Direction, float Elevation)
+	{
+		if (Settings.HasOcean && Elevation < Settings.OceanLevel)
+		{
+			return Settings.ImpostorOceanColor;
+		}
+		return GetSurfaceAlbedo(Direction, Elevation);
+	};
+
+	FPlanetImpostorBaker::Bake(Resolution, ElevationAt, AlbedoAt, OutAtlas);
+}
+
+FLinearColor FPlanetMeshBuilder::GetSurfaceAlbedo(const FVector& PointOnUnitSphere, float Elevation) const
+{
+	// Same height normalization and biome resolution as the mesh vertices
+	const float Height = FMath::Clamp(Elevation, 0.0f, 1.0f);
+	const float Temperature = GetTemperature(PointOnUnitSphere);
+	const float Moisture = GetMoisture(PointOnUnitSphere);
+
+	if (BiomeLookup.IsBuilt())
+	{
+		return BiomeLookup.GetColor(BiomeLookup.Classify(Height, Temperature, Moisture));
+	}
+
+	return GetBiomeColor(DetermineBiome(Height, Temperature, Moisture));
+}
+
+void FPlanetMeshBuilder::CreateIcosphere(FPlanetBuildResult& Result)
+{
+	// Create an icosahedron (20-sided polyhedron)
+	TArray<FVector>& Vertices = Result.UnitVertices;
+	TArray<int32>& Triangles = Result.Triangles;
+	TArray<int32>& TriangleNeighbours = Result.TriangleNeighbours;
+
+	const float t = (1.0f + FMath::Sqrt(5.0f)) / 2.0f;
+
+	// Add vertices
+	Vertices.Add(FVector(-1, t, 0).GetSafeNormal());
+	Vertices.Add(FVector(1, t, 0).GetSafeNormal());
+	Vertices.Add(FVector(-1, -t, 0).GetSafeNormal());
+	Vertices.Add(FVector(1, -t, 0).GetSafeNormal());
+
+	Vertices.Add(FVector(0, -1, t).GetSafeNormal());
+	Vertices.Add(FVector(0, 1, t).GetSafeNormal());
+	Vertices.Add(FVector(0, -1, -t).GetSafeNormal());
+	Vertices.Add(FVector(0, 1, -t).GetSafeNormal());
+
+	Vertices.Add(FVector(t, 0, -1).GetSafeNormal());
+	Vertices.Add(FVector(t, 0, 1).GetSafeNormal());
+	Vertices.Add(FVector(-t, 0, -1).GetSafeNormal());
+	Vertices.Add(FVector(-t, 0, 1).GetSafeNormal());
+
+	// FIXED: Ensure consistent winding order for all triangles (clockwise)
+	// 5 faces around point 0
+	Triangles.Add(0); Triangles.Add(5); Triangles.Add(11);
+	Triangles.Add(0); Triangles.Add(1); Triangles.Add(5);
+	Triangles.Add(0); Triangles.Add(7); Triangles.Add(1);
+	Triangles.Add(0); Triangles.Add(10); Triangles.Add(7);
+	Triangles.Add(0); Triangles.Add(11); Triangles.Add(10);
+
+	// 5 adjacent faces
+	Triangles.Add(1); Triangles.Add(9); Triangles.Add(5);
+	Triangles.Add(5); Triangles.Add(4); Triangles.Add(11);
+	Triangles.Add(11); Triangles.Add(2); Triangles.Add(10);
+	Triangles.Add(10); Triangles.Add(6); Triangles.Add(7);
+	Triangles.Add(7); Triangles.Add(8); Triangles.Add(1);
+
+	// 5 faces around point 3
+	Triangles.Add(3); Triangles.Add(4); Triangles.Add(9);
+	Triangles.Add(3); Triangles.Add(2); Triangles.Add(4);
+	Triangles.Add(3); Triangles.Add(6); Triangles.Add(2);
+	Triangles.Add(3); Triangles.Add(8); Triangles.Add(6);
+	Triangles.Add(3); Triangles.Add(9); Triangles.Add(8);
+
+	// 5 adjacent faces
+	Triangles.Add(4); Triangles.Add(5); Triangles.Add(9);
+	Triangles.Add(2); Triangles.Add(11); Triangles.Add(4);
+	Triangles.Add(6); Triangles.Add(10); Triangles.Add(2);
+	Triangles.Add(8); Triangles.Add(7); Triangles.Add(6);
+	Triangles.Add(9); Triangles.Add(1); Triangles.Add(8);
+
+	// Find the triangle across each edge; the icosahedron is small enough to match edges directly
+	const int32 NumTriangles = Triangles.Num() / 3;
+	TriangleNeighbours.Init(INDEX_NONE, Triangles.Num());
+	for (int32 i = 0; i < NumTriangles; i++)
+	{
+		for (int32 k = 0; k < 3; k++)
+		{
+			int32 A = Triangles[i * 3 + k];
+			int32 B = Triangles[i * 3 + (k + 1) % 3];
+
+			for (int32 j = 0; j < NumTriangles && TriangleNeighbours[i * 3 + k] == INDEX_NONE; j++)
+			{
+				for (int32 m = 0; m < 3; m++)
+				{
+					if (j != i && Triangles[j * 3 + m] == B && Triangles[j * 3 + (m + 1) % 3] == A)
+					{
+						TriangleNeighbours[i * 3 + k] = j;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Icosphere created with %d vertices and %d triangles"), Vertices.Num(), Triangles.Num() / 3);
+}
+
+void FPlanetMeshBuilder::SubdivideIcosphere(FPlanetBuildResult& Result, int32 Subdivisions)
+{
+	if (Subdivisions <= 0)
+	{
+		return;
+	}
+
+	TArray<FVector>& Vertices = Result.UnitVertices;
+	TArray<int32>& Triangles = Result.Triangles;
+	TArray<int32>& TriangleNeighbours = Result.TriangleNeighbours;
+
+	// Returns the child of Tri that sits at the given corner vertex of Tri
+	auto ChildAtCorner = [&Triangles](int32 Tri, int32 Vertex) -> int32
+	{
+		for (int32 Corner = 0; Corner < 3; Corner++)
+		{
+			if (Triangles[Tri * 3 + Corner] == Vertex)
+			{
+				return Tri * 4 + Corner;
+			}
+		}
+
+		checkNoEntry();
+		return INDEX_NONE;
+	};
+
+	// Size everything for the last level up front; a closed triangle mesh has F / 2 + 2 vertices
+	const int32 FinalIndices = Triangles.Num() << (2 * Subdivisions);
+	Vertices.Reserve(FinalIndices / 6 + 2);
+	Triangles.Reserve(FinalIndices);
+	TriangleNeighbours.Reserve(FinalIndices);
+
+	// Each level writes into the scratch buffers and swaps them in, so no level allocates
+	TArray<int32>& NewTriangles = Result.ScratchTriangles;
+	TArray<int32>& NewNeighbours = Result.ScratchNeighbours;
+	TArray<int32>& EdgeMidpoints = Result.ScratchMidpoints;
+	NewTriangles.Reserve(FinalIndices);
+	NewNeighbours.Reserve(FinalIndices);
+
+	for (int32 i = 0; i < Subdivisions; i++)
+	{
+		const int32 NumTriangles = Triangles.Num() / 3;
+
+		NewTriangles.SetNumUninitialized(NumTriangles * 12, EAllowShrinking::No);
+		NewNeighbours.SetNumUninitialized(NumTriangles * 12, EAllowShrinking::No);
+
+		// Mid point created for each triangle edge, shared with the neighbour across that edge.
+		// Every byte 0xFF is INDEX_NONE in every slot.
+		EdgeMidpoints.SetNumUninitialized(NumTriangles * 3, EAllowShrinking::No);
+		FMemory::Memset(EdgeMidpoints.GetData(), 0xFF, EdgeMidpoints.Num() * EdgeMidpoints.GetTypeSize());
+
+		// Subdivide each triangle into 4 triangles
+		for (int32 j = 0; j < NumTriangles; j++)
+		{
+			int32 Mid[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };
+			for (int32 k = 0; k < 3; k++)
+			{
+				// Reuse the mid point if the neighbour across this edge has already been split
+				int32 Neighbour = TriangleNeighbours[j * 3 + k];
+				for (int32 NeighbourEdge = 0; NeighbourEdge < 3; NeighbourEdge++)
+				{
+					if (TriangleNeighbours[Neighbour * 3 + NeighbourEdge] == j)
+					{
+						Mid[k] = EdgeMidpoints[Neighbour * 3 + NeighbourEdge];
+						break;
+					}
+				}
+
+				if (Mid[k] == INDEX_NONE)
+				{
+					// Normalize so the new point is on the unit sphere
+					const FVector Middle = (Vertices[Triangles[j * 3 + k]] + Vertices[Triangles[j * 3 + (k + 1) % 3]]) * 0.5f;
+					Mid[k] = Vertices.Add(Middle.GetSafeNormal());
+				}
+
+				EdgeMidpoints[j * 3 + k] = Mid[k];
+			}
+
+			int32 v1 = Triangles[j * 3];
+			int32 v2 = Triangles[j * 3 + 1];
+			int32 v3 = Triangles[j * 3 + 2];
+			int32 a = Mid[0];
+			int32 b = Mid[1];
+			int32 c = Mid[2];
+
+			int32 n1 = TriangleNeighbours[j * 3];
+			int32 n2 = TriangleNeighbours[j * 3 + 1];
+			int32 n3 = TriangleNeighbours[j * 3 + 2];
+
+			// Create 4 new triangles; the children of triangle j are 4j .. 4j + 3
+			int32* T = &NewTriangles[j * 12];
+			T[0] = v1; T[1] = a; T[2] = c;
+			T[3] = v2; T[4] = b; T[5] = a;
+			T[6] = v3; T[7] = c; T[8] = b;
+			T[9] = a; T[10] = b; T[11] = c;
+
+			// Outer edges of the corner children border the matching corner child of the old neighbour
+			const int32 Centre = j * 4 + 3;
+			int32* N = &NewNeighbours[j * 12];
+			N[0] = ChildAtCorner(n1, v1); N[1] = Centre; N[2] = ChildAtCorner(n3, v1);
+			N[3] = ChildAtCorner(n2, v2); N[4] = Centre; N[5] = ChildAtCorner(n1, v2);
+			N[6] = ChildAtCorner(n3, v3); N[7] = Centre; N[8] = ChildAtCorner(n2, v3);
+			N[9] = j * 4 + 1; N[10] = j * 4 + 2; N[11] = j * 4;
+		}
+
+		Swap(Triangles, NewTriangles);
+		Swap(TriangleNeighbours, NewNeighbours);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Subdivided icosphere to %d vertices and %d triangles"), Vertices.Num(), Triangles.Num() / 3);
+}
+
+void FPlanetMeshBuilder::OptimizeMeshOrder(FPlanetBuildResult& Result)
+{
+	TArray<FVector>& Vertices = Result.UnitVertices;
+	TArray<int32>& Triangles = Result.Triangles;
+	TArray<int32>& TriangleNeighbours = Result.TriangleNeighbours;
+	FPlanetGenerationStats& Stats = Result.Stats;
+
+	const int32 NumVertices = Vertices.Num();
+	const int32 NumTriangles = Triangles.Num() / 3;
+
+	Stats.VertexCacheMissRatioBefore = FPlanetMeshOrder::ComputeACMR(Triangles, NumVertices);
+	Stats.VertexFetchMissesBefore = FPlanetMeshOrder::ComputeFetchMisses(Triangles, sizeof(FVector));
+
+	FMemMark Mark(FMemStack::Get());
+
+	// The subdivision's scratch buffers are free again and already close to the right size. Order
+	// holds the vertex order first and the triangle order after it; the vertex order is fully
+	// applied before the triangle order overwrites it.
+	TArray<int32>& Order = Result.ScratchMidpoints;
+
+	// Vertices along the curve, so every per-vertex pass walks the surface instead of jumping around it
+	FPlanetMeshOrder::SortVerticesAlongCurve(Vertices, Order);
+
+	TArray<int32, TMemStackAllocator<>> NewVertexIndex;
+	NewVertexIndex.SetNumUninitialized(NumVertices);
+	{
+		TArray<FVector, TMemStackAllocator<>> OldVertices(Vertices.GetData(), NumVertices);
+		for (int32 i = 0; i < NumVertices; i++)
+		{
+			Vertices[i] = OldVertices[Order[i]];
+			NewVertexIndex[Order[i]] = i;
+		}
+	}
+
+	for (int32& Index : Triangles)
+	{
+		Index = NewVertexIndex[Index];
+	}
+
+	// Triangles in vertex cache order. Corners keep their order, so each neighbour slot still
+	// names the same edge and only the neighbour indices need remapping.
+	FPlanetMeshOrder::OptimizeTriangleOrder(Triangles, NumVertices, FPlanetMeshOrder::VertexCacheSize, Order);
+
+	TArray<int32, TMemStackAllocator<>> NewTriangleIndex;
+	NewTriangleIndex.SetNumUninitialized(NumTriangles);
+	for (int32 i = 0; i < NumTriangles; i++)
+	{
+		NewTriangleIndex[Order[i]] = i;
+	}
+
+	TArray<int32>& NewTriangles = Result.ScratchTriangles;
+	TArray<int32>& NewNeighbours = Result.ScratchNeighbours;
+	NewTriangles.SetNumUninitialized(NumTriangles * 3, EAllowShrinking::No);
+	NewNeighbours.SetNumUninitialized(NumTriangles * 3, EAllowShrinking::No);
+	for (int32 i = 0; i < NumTriangles; i++)
+	{
+		const int32 Old = Order[i];
+		for (int32 Corner = 0; Corner < 3; Corner++)
+		{
+			NewTriangles[i * 3 + Corner] = Triangles[Old * 3 + Corner];
+			NewNeighbours[i * 3 + Corner] = NewTriangleIndex[TriangleNeighbours[Old * 3 + Corner]];
+		}
+	}
+
+	Swap(Triangles, NewTriangles);
+	Swap(TriangleNeighbours, NewNeighbours);
+
+	Stats.VertexCacheMissRatioAfter = FPlanetMeshOrder::ComputeACMR(Triangles, NumVertices);
+	Stats.VertexFetchMissesAfter = FPlanetMeshOrder::ComputeFetchMisses(Triangles, sizeof(FVector));
+}
+
+float FPlanetMeshBuilder::EvaluateNoise(const FVector& PointOnUnitSphere) const
+{
+	float FirstLayerValue = 0;
+	float Elevation = 0;
+	float Weight = 1;
+
+	for (int32 i = 0; i < Settings.NoiseLayers.Num(); i++)
+	{
+		const FNoiseLayer& NoiseLayer = Settings.NoiseLayers[i];
+		if (!NoiseLayer.Enabled)
+		{
+			continue;
+		}
+
+		float Amplitude = 1;
+		float Frequency = NoiseLayer.BaseRoughness;
+		float NoiseValue = 0;
+		const FVector LayerCenter = NoiseLayer.Center + LayerOffsets[i];
+
+		for (int32 j = 0; j < NoiseLayer.NumLayers; j++)
+		{
+			FVector SamplePoint = PointOnUnitSphere * Frequency + LayerCenter;
+
+			// Use SimplexNoise from the SimplexNoiseBPLibrary
+			float Noise = USimplexNoiseBPLibrary::SimplexNoise3DDefaultSeed(SamplePoint.X, SamplePoint.Y, SamplePoint.Z);
+			NoiseValue += (Noise + 1) * 0.5f * Amplitude;
+
+			Frequency *= NoiseLayer.Roughness;
+			Amplitude *= NoiseLayer.Persistence;
+		}
+
+		if (NoiseLayer.MinValue > 0)
+		{
+			NoiseValue = FMath::Max(0.0f, NoiseValue - NoiseLayer.MinValue);
+		}
+
+		NoiseValue *= NoiseLayer.Strength;
+
+		if (i == 0)
+		{
+			FirstLayerValue = NoiseValue;
+		}
+		else
+		{
+			float Mask = FirstLayerValue;
+			NoiseValue *= Mask;
+		}
+
+		Elevation += NoiseValue * Weight;
+		Weight *= 0.5f;
+	}
+
+	return Elevation;
+}
+
+FVector FPlanetMeshBuilder::CalculatePointOnPlanet(const FVector& PointOnUnitSphere) const
+{
+	float Elevation = EvaluateNoise(PointOnUnitSphere);
+	float FinalElevation = Settings.PlanetRadius * (1 + Elevation * 0.2f);
+	return PointOnUnitSphere * FinalElevation;
+}
+
+float FPlanetMeshBuilder::GetTemperature(const FVector& PointOnUnitSphere) const
+{
+	// Temperature decreases from equator to poles
+	float LatitudeFactor = 1.0f - FMath::Abs(PointOnUnitSphere.Z);
+	float Temperature = FMath::Lerp(Settings.PoleTemperature, Settings.EquatorTemperature, LatitudeFactor);
+
+	// Add some noise for more natural temperature distribution
+	FVector SamplePoint = PointOnUnitSphere * 3.7f;
+	float TemperatureNoise = USimplexNoiseBPLibrary::SimplexNoise3DDefaultSeed(SamplePoint.X, SamplePoint.Y, SamplePoint.Z) * 0.1f;
+
+	return FMath::Clamp(Temperature + TemperatureNoise, 0.0f, 1.0f);
+}
+
+float FPlanetMeshBuilder::GetMoisture(const FVector& PointOnUnitSphere) const
+{
+	// Base moisture with noise
+	FVector SamplePoint = PointOnUnitSphere * 5.3f * Settings.MoistureScale;
+	float Moisture = (USimplexNoiseBPLibrary::SimplexNoise3DDefaultSeed(SamplePoint.X, SamplePoint.Y, SamplePoint.Z) + 1.0f) * 0.5f;
+
+	// Moisture tends to be higher near the equator and lower near the poles
+	float LatitudeFactor = 1.0f - FMath::Abs(PointOnUnitSphere.Z);
+	Moisture *= FMath::Lerp(0.7f, 1.0f, LatitudeFactor);
+
+	return FMath::Clamp(Moisture, 0.0f, 1.0f);
+}
+
+EBiomeType FPlanetMeshBuilder::DetermineBiome(float Height, float Temperature, float Moisture) const
+{
+	if (BiomeLookup.IsBuilt())
+	{
+		return BiomeLookup.GetBiomeType(BiomeLookup.Classify(Height, Temperature, Moisture));
+	}
+
+	// Then check all other biomes
+	for (const FBiomeSettings& Biome : Settings.Biomes)
+	{
+		if (Height >= Biome.MinHeight && Height <= Biome.MaxHeight &&
+			Temperature >= Biome.MinTemperature && Temperature <= Biome.MaxTemperature &&
+			Moisture >= Biome.MinMoisture && Moisture <= Biome.MaxMoisture)
+		{
+			return Biome.BiomeType;
+		}
+	}
+
+	// Default to plains if no match
+	return EBiomeType::Plains;
+}
+
+FLinearColor FPlanetMeshBuilder::GetBiomeColor(EBiomeType BiomeType) const
+{
+	for (const FBiomeSettings& Biome : Settings.Biomes)
+	{
+		if (Biome.BiomeType == BiomeType)
+		{
+			return Biome.BiomeColor;
+		}
+	}
+
+	// Default color if biome not found
+	return FLinearColor(0.5f, 0.5f, 0.5f, 1.0f);
+}
+
+float FPlanetMeshBuilder::GetOceanRadius() const
+{
+	// Same height scale as CalculatePointOnPlanet
+	return Settings.PlanetRadius * (1.0f + Settings.OceanLevel * 0.2f);
+}
+
+bool FPlanetMeshBuilder::UsesBiomePalette() const
+{
+	// Every biome plus the no-match entry needs a slot below the highlight slot
+	return Settings.ColorMode == EPlanetColorMode::BiomePalette && BiomeLookup.IsBuilt() && BiomeLookup.GetNumSlots() < HighlightPaletteSlot;
+}
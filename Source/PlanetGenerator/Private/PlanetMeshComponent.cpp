@@ -0,0 +1,608 @@
+#include "PlanetMeshComponent.h"
+#include "PrimitiveSceneProxy.h"
+#include "LocalVertexFactory.h"
+#include "MeshBatch.h"
+#include "SceneInterface.h"
+#include "RenderResource.h"
+#include "RenderingThread.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialRenderProxy.h"
+#include "PhysicsEngine/BodySetup.h"
+
+void FPlanetMeshStreams::SetNum(int32 NumVertices)
+{
+	Positions.SetNumUninitialized(NumVertices, EAllowShrinking::No);
+	TangentBasis.SetNumUninitialized(NumVertices * 2, EAllowShrinking::No);
+	TexCoords.SetNumUninitialized(NumVertices, EAllowShrinking::No);
+	Colors.SetNumUninitialized(NumVertices, EAllowShrinking::No);
+}
+
+void FPlanetMeshStreams::Reset()
+{
+	Positions.Reset();
+	TangentBasis.Reset();
+	TexCoords.Reset();
+	Colors.Reset();
+}
+
+SIZE_T FPlanetMeshStreams::GetAllocatedSize() const
+{
+	return Positions.GetAllocatedSize() + TangentBasis.GetAllocatedSize() + TexCoords.GetAllocatedSize() + Colors.GetAllocatedSize();
+}
+
+// Render triangles of one or more planets. The CPU copy stays for collision cooking; the GPU
+// copy uses 16-bit indices whenever the vertices allow it.
+class FPlanetIndexBuffer : public FIndexBuffer
+{
+public:
+	explicit FPlanetIndexBuffer(TArrayView<const int32> Triangles)
+		: Indices(Triangles)
+	{
+		for (int32 Index : Indices)
+		{
+			MaxIndex = FMath::Max(MaxIndex, Index);
+		}
+	}
+
+	virtual void InitRHI(FRHICommandListBase& RHICmdList) override
+	{
+		if (Indices.Num() == 0)
+		{
+			return;
+		}
+
+		const bool b32Bit = MaxIndex > MAX_uint16;
+		const uint32 Stride = b32Bit ? sizeof(uint32) : sizeof(uint16);
+		const uint32 Size = Stride * Indices.Num();
+
+		FRHIResourceCreateInfo CreateInfo(TEXT("PlanetIndexBuffer"));
+		IndexBufferRHI = RHICmdList.CreateIndexBuffer(Stride, Size, BUF_Static, CreateInfo);
+
+		void* Data = RHICmdList.LockBuffer(IndexBufferRHI, 0, Size, RLM_WriteOnly);
+		if (b32Bit)
+		{
+			FMemory::Memcpy(Data, Indices.GetData(), Size);
+		}
+		else
+		{
+			uint16* Indices16 = (uint16*)Data;
+			for (int32 i = 0; i < Indices.Num(); i++)
+			{
+				Indices16[i] = (uint16)Indices[i];
+			}
+		}
+		RHICmdList.UnlockBuffer(IndexBufferRHI);
+	}
+
+	int32 GetNumIndices() const { return Indices.Num(); }
+	const TArray<int32>& GetIndices() const { return Indices; }
+
+private:
+	TArray<int32> Indices;
+	int32 MaxIndex = 0;
+};
+
+// One vertex stream of the local vertex factory. Data has to stay valid until the resource is
+// released, since the RHI may recreate the buffer and upload it again.
+class FPlanetVertexStream : public FVertexBuffer
+{
+public:
+	void Init(const void* InData, int32 InNumElements, uint32 InStride, EPixelFormat InFormat, EBufferUsageFlags InUsage = BUF_Static)
+	{
+		Data = InData;
+		NumElements = InNumElements;
+		Stride = InStride;
+		Format = InFormat;
+		Usage = InUsage;
+	}
+
+	virtual void InitRHI(FRHICommandListBase& RHICmdList) override
+	{
+		if (!Data || NumElements == 0)
+		{
+			return;
+		}
+
+		FRHIResourceCreateInfo CreateInfo(TEXT("PlanetVertexStream"));
+		VertexBufferRHI = RHICmdList.CreateVertexBuffer(Stride * NumElements, Usage | BUF_ShaderResource, CreateInfo);
+		Upload(RHICmdList);
+
+		ShaderResourceView = RHICmdList.CreateShaderResourceView(VertexBufferRHI, GPixelFormats[Format].BlockBytes, Format);
+	}
+
+	virtual void ReleaseRHI() override
+	{
+		ShaderResourceView.SafeRelease();
+		FVertexBuffer::ReleaseRHI();
+	}
+
+	// Copies all of Data into the buffer. Always the whole buffer: a write-only lock of a dynamic
+	// buffer discards its previous contents on some RHIs, so a partial write would lose the rest.
+	void Upload(FRHICommandListBase& RHICmdList)
+	{
+		if (!VertexBufferRHI.IsValid())
+		{
+			return;
+		}
+
+		const uint32 Size = Stride * NumElements;
+		void* Dest = RHICmdList.LockBuffer(VertexBufferRHI, 0, Size, RLM_WriteOnly);
+		FMemory::Memcpy(Dest, Data, Size);
+		RHICmdList.UnlockBuffer(VertexBufferRHI);
+	}
+
+	FShaderResourceViewRHIRef ShaderResourceView;
+
+private:
+	const void* Data = nullptr;
+	int32 NumElements = 0;
+	uint32 Stride = 0;
+	EPixelFormat Format = PF_Unknown;
+	EBufferUsageFlags Usage = BUF_Static;
+};
+
+// Colours of vertices [X, X + Y) in one update
+using FPlanetColorRange = FIntPoint;
+
+class FPlanetMeshSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+	FPlanetMeshSceneProxy(UPlanetMeshComponent* Component)
+		: FPrimitiveSceneProxy(Component)
+		, Streams(Component->GetStreams())
+		, IndexBuffer(Component->GetIndexBuffer())
+		, VertexFactory(GetScene().GetFeatureLevel(), "FPlanetMeshSceneProxy")
+		, MaterialRelevance(Component->GetMaterialRelevance(GetScene().GetFeatureLevel()))
+	{
+		Material = Component->GetMaterial(0);
+		if (!Material)
+		{
+			Material = UMaterial::GetDefaultMaterial(MD_Surface);
+		}
+
+		// The proxy keeps its own colours so the component can change its copy on the game thread
+		// while the render thread patches this one
+		NumVertices = Streams->Num();
+		ColorData = Streams->Colors;
+
+		PositionStream.Init(Streams->Positions.GetData(), NumVertices, sizeof(FVector3f), PF_R32_FLOAT);
+		TangentStream.Init(Streams->TangentBasis.GetData(), NumVertices, sizeof(FPackedNormal) * 2, PF_R8G8B8A8_SNORM);
+		TexCoordStream.Init(Streams->TexCoords.GetData(), NumVertices, sizeof(FVector2f), PF_G32R32F);
+		ColorStream.Init(ColorData.GetData(), NumVertices, sizeof(FColor), PF_R8G8B8A8, BUF_Dynamic);
+
+		ENQUEUE_RENDER_COMMAND(InitPlanetMeshSceneProxy)([this](FRHICommandListImmediate& RHICmdList)
+		{
+			PositionStream.InitResource(RHICmdList);
+			TangentStream.InitResource(RHICmdList);
+			TexCoordStream.InitResource(RHICmdList);
+			ColorStream.InitResource(RHICmdList);
+
+			FLocalVertexFactory::FDataType Data;
+			Data.PositionComponent = FVertexStreamComponent(&PositionStream, 0, sizeof(FVector3f), VET_Float3);
+			Data.PositionComponentSRV = PositionStream.ShaderResourceView;
+			Data.TangentBasisComponents[0] = FVertexStreamComponent(&TangentStream, 0, sizeof(FPackedNormal) * 2, VET_PackedNormal);
+			Data.TangentBasisComponents[1] = FVertexStreamComponent(&TangentStream, sizeof(FPackedNormal), sizeof(FPackedNormal) * 2, VET_PackedNormal);
+			Data.TangentsSRV = TangentStream.ShaderResourceView;
+			Data.TextureCoordinates.Add(FVertexStreamComponent(&TexCoordStream, 0, sizeof(FVector2f), VET_Float2));
+			Data.TextureCoordinatesSRV = TexCoordStream.ShaderResourceView;
+			Data.NumTexCoords = 1;
+			Data.LightMapCoordinateIndex = 0;
+			Data.ColorComponent = FVertexStreamComponent(&ColorStream, 0, sizeof(FColor), VET_Color);
+			Data.ColorComponentsSRV = ColorStream.ShaderResourceView;
+			Data.ColorIndexMask = ~0u;
+			VertexFactory.SetData(RHICmdList, Data);
+			VertexFactory.InitResource(RHICmdList);
+		});
+	}
+
+	virtual ~FPlanetMeshSceneProxy()
+	{
+		PositionStream.ReleaseResource();
+		TangentStream.ReleaseResource();
+		TexCoordStream.ReleaseResource();
+		ColorStream.ReleaseResource();
+		VertexFactory.ReleaseResource();
+	}
+
+	virtual SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+	// Colors holds the colours of each range in turn; the stream is uploaded once for all of them
+	void UpdateColors_RenderThread(FRHICommandListBase& RHICmdList, const TArray<FPlanetColorRange>& Ranges, const TArray<FColor>& Colors)
+	{
+		int32 Offset = 0;
+		for (const FPlanetColorRange& Range : Ranges)
+		{
+			FMemory::Memcpy(&ColorData[Range.X], &Colors[Offset], Range.Y * sizeof(FColor));
+			Offset += Range.Y;
+		}
+
+		ColorStream.Upload(RHICmdList);
+	}
+
+	// The surface only changes with a new mesh, so it is drawn through cached static draw commands
+	virtual void DrawStaticElements(FStaticPrimitiveDrawInterface* PDI) override
+	{
+		if (NumVertices == 0 || !IndexBuffer.IsValid() || IndexBuffer->GetNumIndices() == 0)
+		{
+			return;
+		}
+
+		FMeshBatch Mesh;
+		FMeshBatchElement& Element = Mesh.Elements[0];
+		Element.IndexBuffer = IndexBuffer.Get();
+		Element.FirstIndex = 0;
+		Element.NumPrimitives = IndexBuffer->GetNumIndices() / 3;
+		Element.MinVertexIndex = 0;
+		Element.MaxVertexIndex = NumVertices - 1;
+
+		Mesh.VertexFactory = &VertexFactory;
+		Mesh.MaterialRenderProxy = Material->GetRenderProxy();
+		Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+		Mesh.Type = PT_TriangleList;
+		Mesh.DepthPriorityGroup = SDPG_World;
+		Mesh.CastShadow = true;
+		Mesh.LODIndex = 0;
+
+		PDI->DrawMesh(Mesh, FLT_MAX);
+	}
+
+	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+	{
+		FPrimitiveViewRelevance Result;
+		Result.bDrawRelevance = IsShown(View);
+		Result.bShadowRelevance = IsShadowCast(View);
+		Result.bStaticRelevance = true;
+		Result.bRenderInMainPass = ShouldRenderInMainPass();
+		Result.bUsesLightingChannels = GetLightingChannelMask() != GetDefaultLightingChannelMask();
+		Result.bRenderCustomDepth = ShouldRenderCustomDepth();
+		Result.bTranslucentSelfShadow = bCastVolumetricTranslucentShadow;
+		MaterialRelevance.SetPrimitiveViewRelevance(Result);
+		Result.bVelocityRelevance = DrawsVelocity() && Result.bOpaque && Result.bRenderInMainPass;
+		return Result;
+	}
+
+	virtual bool CanBeOccluded() const override
+	{
+		return !MaterialRelevance.bDisableDepthTest;
+	}
+
+	virtual uint32 GetMemoryFootprint() const override
+	{
+		return sizeof(*this) + GetAllocatedSize() + ColorData.GetAllocatedSize();
+	}
+
+private:
+	// Positions, tangents and UVs are read from here whenever the buffers are (re)created;
+	// the component never changes them after SetMesh
+	TSharedPtr<const FPlanetMeshStreams, ESPMode::ThreadSafe> Streams;
+	TArray<FColor> ColorData;
+	TSharedPtr<FPlanetIndexBuffer, ESPMode::ThreadSafe> IndexBuffer;
+
+	FPlanetVertexStream PositionStream;
+	FPlanetVertexStream TangentStream;
+	FPlanetVertexStream TexCoordStream;
+	FPlanetVertexStream ColorStream;
+	FLocalVertexFactory VertexFactory;
+
+	UMaterialInterface* Material = nullptr;
+	FMaterialRelevance MaterialRelevance;
+	int32 NumVertices = 0;
+};
+
+UPlanetMeshComponent::UPlanetMeshComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+TSharedRef<FPlanetIndexBuffer, ESPMode::ThreadSafe> UPlanetMeshComponent::FindOrCreateIndexBuffer(TArrayView<const int32> Triangles, int32 SharedKey)
+{
+	check(IsInGameThread());
+
+	// Only weak references, so a buffer goes away with the last planet drawing it
+	static TMap<int32, TWeakPtr<FPlanetIndexBuffer, ESPMode::ThreadSafe>> SharedBuffers;
+
+	if (SharedKey != INDEX_NONE)
+	{
+		if (TSharedPtr<FPlanetIndexBuffer, ESPMode::ThreadSafe> Existing = SharedBuffers.FindRef(SharedKey).Pin())
+		{
+			if (Existing->GetNumIndices() == Triangles.Num())
+			{
+				return Existing.ToSharedRef();
+			}
+		}
+	}
+
+	// The last reference can drop on either thread; the RHI resource is released on the render thread
+	TSharedRef<FPlanetIndexBuffer, ESPMode::ThreadSafe> Buffer = MakeShareable(new FPlanetIndexBuffer(Triangles), [](FPlanetIndexBuffer* Released)
+	{
+		ENQUEUE_RENDER_COMMAND(ReleasePlanetIndexBuffer)([Released](FRHICommandListImmediate& RHICmdList)
+		{
+			Released->ReleaseResource();
+			delete Released;
+		});
+	});
+	BeginInitResource(&Buffer.Get());
+
+	if (SharedKey != INDEX_NONE)
+	{
+		SharedBuffers.Add(SharedKey, Buffer);
+	}
+
+	return Buffer;
+}
+
+void UPlanetMeshComponent::SetMesh(FPlanetMeshStreams&& InStreams, TSharedRef<FPlanetIndexBuffer, ESPMode::ThreadSafe> InIndexBuffer, bool bCreateCollision)
+{
+	// The render thread may still draw retired streams, so only an unshared one is reused
+	TSharedPtr<FPlanetMeshStreams, ESPMode::ThreadSafe> NewStreams;
+	for (int32 Index = 0; Index < RetiredStreams.Num(); Index++)
+	{
+		if (RetiredStreams[Index].GetSharedReferenceCount() == 1)
+		{
+			NewStreams = MoveTemp(RetiredStreams[Index]);
+			RetiredStreams.RemoveAt(Index);
+			Swap(*NewStreams, InStreams);
+			InStreams.Reset();
+			break;
+		}
+	}
+	if (!NewStreams.IsValid())
+	{
+		NewStreams = MakeShared<FPlanetMeshStreams, ESPMode::ThreadSafe>(MoveTemp(InStreams));
+	}
+
+	RetireStreams();
+	Streams = MoveTemp(NewStreams);
+	IndexBuffer = InIndexBuffer;
+
+	LocalBounds = FBox(ForceInit);
+	for (const FVector3f& Position : Streams->Positions)
+	{
+		LocalBounds += FVector(Position);
+	}
+
+	bCollisionFromMesh = bCreateCollision;
+	UpdateCollision();
+
+	UpdateBounds();
+	MarkRenderStateDirty();
+}
+
+void UPlanetMeshComponent::ClearMesh()
+{
+	if (!Streams.IsValid() && !IndexBuffer.IsValid())
+	{
+		return;
+	}
+
+	RetireStreams();
+	IndexBuffer.Reset();
+	LocalBounds = FBox(ForceInit);
+
+	bCollisionFromMesh = false;
+	UpdateCollision();
+
+	UpdateBounds();
+	MarkRenderStateDirty();
+}
+
+void UPlanetMeshComponent::UpdateVertexColors(int32 FirstVertex, TArrayView<const FColor> NewColors)
+{
+	if (!Streams.IsValid() || FirstVertex < 0 || FirstVertex + NewColors.Num() > Streams->Num() || NewColors.Num() == 0)
+	{
+		return;
+	}
+
+	FMemory::Memcpy(&Streams->Colors[FirstVertex], NewColors.GetData(), NewColors.Num() * sizeof(FColor));
+
+	TArray<FPlanetColorRange> Ranges;
+	Ranges.Add(FPlanetColorRange(FirstVertex, NewColors.Num()));
+	SendColorRanges(MoveTemp(Ranges));
+}
+
+void UPlanetMeshComponent::UpdateVertexColors(TArrayView<const int32> Vertices, TArrayView<const FColor> NewColors)
+{
+	if (!Streams.IsValid() || Vertices.Num() != NewColors.Num() || Vertices.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<int32> Sorted;
+	Sorted.Reserve(Vertices.Num());
+	for (int32 i = 0; i < Vertices.Num(); i++)
+	{
+		if (Streams->Colors.IsValidIndex(Vertices[i]))
+		{
+			Streams->Colors[Vertices[i]] = NewColors[i];
+			Sorted.Add(Vertices[i]);
+		}
+	}
+	Sorted.Sort();
+
+	// Neighbouring vertices go out as one range
+	TArray<FPlanetColorRange> Ranges;
+	for (int32 Vertex : Sorted)
+	{
+		if (Ranges.Num() > 0 && Vertex <= Ranges.Last().X + Ranges.Last().Y)
+		{
+			Ranges.Last().Y = FMath::Max(Ranges.Last().Y, Vertex - Ranges.Last().X + 1);
+		}
+		else
+		{
+			Ranges.Add(FPlanetColorRange(Vertex, 1));
+		}
+	}
+
+	SendColorRanges(MoveTemp(Ranges));
+}
+
+void UPlanetMeshComponent::SendColorRanges(TArray<FPlanetColorRange>&& Ranges)
+{
+	// A proxy waiting to be recreated will pick the colours up from the streams
+	FPlanetMeshSceneProxy* Proxy = static_cast<FPlanetMeshSceneProxy*>(SceneProxy);
+	if (!Proxy || IsRenderStateDirty() || Ranges.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FColor> Colors;
+	for (const FPlanetColorRange& Range : Ranges)
+	{
+		Colors.Append(&Streams->Colors[Range.X], Range.Y);
+	}
+
+	ENQUEUE_RENDER_COMMAND(UpdatePlanetMeshColors)([Proxy, Ranges = MoveTemp(Ranges), Colors = MoveTemp(Colors)](FRHICommandListImmediate& RHICmdList)
+	{
+		Proxy->UpdateColors_RenderThread(RHICmdList, Ranges, Colors);
+	});
+}
+
+void UPlanetMeshComponent::RetireStreams()
+{
+	if (!Streams.IsValid())
+	{
+		return;
+	}
+
+	if (RetiredStreams.Num() == 2)
+	{
+		RetiredStreams.RemoveAt(0);
+	}
+	RetiredStreams.Add(MoveTemp(Streams));
+}
+
+SIZE_T UPlanetMeshComponent::GetRetiredStreamsAllocatedSize() const
+{
+	SIZE_T Size = 0;
+	for (const TSharedPtr<FPlanetMeshStreams, ESPMode::ThreadSafe>& Retired : RetiredStreams)
+	{
+		Size += Retired->GetAllocatedSize();
+	}
+	return Size;
+}
+
+SIZE_T UPlanetMeshComponent::GetMeshAllocatedSize() const
+{
+	SIZE_T Size = Streams.IsValid() ? Streams->GetAllocatedSize() : 0;
+	if (IndexBuffer.IsValid())
+	{
+		Size += IndexBuffer->GetIndices().GetAllocatedSize();
+	}
+	return Size;
+}
+
+FPrimitiveSceneProxy* UPlanetMeshComponent::CreateSceneProxy()
+{
+	if (!Streams.IsValid() || Streams->Num() == 0 || !IndexBuffer.IsValid())
+	{
+		return nullptr;
+	}
+
+	return new FPlanetMeshSceneProxy(this);
+}
+
+UBodySetup* UPlanetMeshComponent::GetBodySetup()
+{
+	return BodySetup;
+}
+
+FBoxSphereBounds UPlanetMeshComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (!LocalBounds.IsValid)
+	{
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.0f);
+	}
+
+	return FBoxSphereBounds(LocalBounds).TransformBy(LocalToWorld);
+}
+
+bool UPlanetMeshComponent::GetPhysicsTriMeshData(FTriMeshCollisionData* CollisionData, bool InUseAllTriData)
+{
+	if (!ContainsPhysicsTriMeshData(InUseAllTriData))
+	{
+		return false;
+	}
+
+	// Cooking needs its own copy; it reads the same positions the GPU draws
+	CollisionData->Vertices = Streams->Positions;
+
+	const TArray<int32>& Indices = IndexBuffer->GetIndices();
+	CollisionData->Indices.SetNumUninitialized(Indices.Num() / 3);
+	for (int32 i = 0; i < CollisionData->Indices.Num(); i++)
+	{
+		FTriIndices& Triangle = CollisionData->Indices[i];
+		Triangle.v0 = Indices[i * 3];
+		Triangle.v1 = Indices[i * 3 + 1];
+		Triangle.v2 = Indices[i * 3 + 2];
+	}
+	CollisionData->MaterialIndices.Init(0, CollisionData->Indices.Num());
+
+	// Same conventions as UProceduralMeshComponent, so traces hit the surface the same way
+	CollisionData->bFlipNormals = true;
+	CollisionData->bDeformableMesh = true;
+	CollisionData->bFastCook = true;
+	return true;
+}
+
+bool UPlanetMeshComponent::ContainsPhysicsTriMeshData(bool InUseAllTriData) const
+{
+	return bCollisionFromMesh && Streams.IsValid() && Streams->Num() > 0 && IndexBuffer.IsValid() && IndexBuffer->GetNumIndices() > 0;
+}
+
+void UPlanetMeshComponent::UpdateCollision()
+{
+	if (!bCollisionFromMesh)
+	{
+		PendingBodySetup = nullptr;
+		if (BodySetup)
+		{
+			BodySetup = nullptr;
+			RecreatePhysicsState();
+		}
+		return;
+	}
+
+	UBodySetup* NewBodySetup = NewObject<UBodySetup>(this, NAME_None, IsTemplate() ? RF_Public | RF_ArchetypeObject : RF_NoFlags);
+	NewBodySetup->BodySetupGuid = FGuid::NewGuid();
+	NewBodySetup->bGenerateMirroredCollision = false;
+	NewBodySetup->bDoubleSidedGeometry = true;
+	NewBodySetup->CollisionTraceFlag = CTF_UseComplexAsSimple;
+
+	UWorld* World = GetWorld();
+	if (World && World->IsGameWorld())
+	{
+		// Cooks off the game thread; the old collision stays until the new one is ready
+		PendingBodySetup = NewBodySetup;
+		NewBodySetup->CreatePhysicsMeshesAsync(FOnAsyncPhysicsCookFinished::CreateUObject(this, &UPlanetMeshComponent::FinishCollisionCook, NewBodySetup));
+	}
+	else
+	{
+		PendingBodySetup = nullptr;
+		BodySetup = NewBodySetup;
+		BodySetup->bHasCookedCollisionData = true;
+		BodySetup->InvalidatePhysicsData();
+		BodySetup->CreatePhysicsMeshes();
+		RecreatePhysicsState();
+	}
+}
+
+void UPlanetMeshComponent::FinishCollisionCook(bool bSuccess, UBodySetup* FinishedBodySetup)
+{
+	// A newer mesh started its own cook in the meantime
+	if (FinishedBodySetup != PendingBodySetup)
+	{
+		return;
+	}
+
+	PendingBodySetup = nullptr;
+	if (bSuccess)
+	{
+		BodySetup = FinishedBodySetup;
+		RecreatePhysicsState();
+	}
+}
@@ -0,0 +1,297 @@
+#include "PlanetMeshOrder.h"
+#include "Misc/MemStack.h"
+#include "Algo/Sort.h"
+
+// Cells along each edge of a cube face on the Hilbert curve. 12 bits per axis leaves room for
+// the face and the vertex index in one 64-bit sort key.
+static constexpr uint32 CurveCells = 1 << 12;
+
+// Position of a cell along the Hilbert curve filling a CurveCells square
+static uint32 HilbertIndex(uint32 X, uint32 Y)
+{
+	uint32 Index = 0;
+	for (uint32 Step = CurveCells / 2; Step > 0; Step /= 2)
+	{
+		const uint32 RX = (X & Step) > 0 ? 1 : 0;
+		const uint32 RY = (Y & Step) > 0 ? 1 : 0;
+		Index += Step * Step * ((3 * RX) ^ RY);
+
+		// Rotate the quadrant so the sub-curve joins its neighbours
+		if (RY == 0)
+		{
+			if (RX == 1)
+			{
+				X = CurveCells - 1 - X;
+				Y = CurveCells - 1 - Y;
+			}
+			Swap(X, Y);
+		}
+	}
+
+	return Index;
+}
+
+static uint32 ToCurveCell(float Coordinate)
+{
+	return (uint32)FMath::Clamp((int32)((Coordinate * 0.5f + 0.5f) * CurveCells), 0, (int32)CurveCells - 1);
+}
+
+void FPlanetMeshOrder::SortVerticesAlongCurve(TArrayView<const FVector> UnitVertices, TArray<int32>& OutOrder)
+{
+	FMemMark Mark(FMemStack::Get());
+
+	// Face, curve position and vertex index packed so a plain sort is stable and deterministic
+	TArray<uint64, TMemStackAllocator<>> Keys;
+	Keys.SetNumUninitialized(UnitVertices.Num());
+	for (int32 i = 0; i < UnitVertices.Num(); i++)
+	{
+		const FVector& Direction = UnitVertices[i];
+		const FVector Abs = Direction.GetAbs();
+		const int32 Axis = Abs.X >= Abs.Y && Abs.X >= Abs.Z ? 0 : (Abs.Y >= Abs.Z ? 1 : 2);
+		const float Major = FMath::Max(Abs[Axis], UE_SMALL_NUMBER);
+		const uint64 Face = Axis + (Direction[Axis] < 0.0f ? 3 : 0);
+
+		const uint32 U = ToCurveCell(Direction[(Axis + 1) % 3] / Major);
+		const uint32 V = ToCurveCell(Direction[(Axis + 2) % 3] / Major);
+		Keys[i] = (Face << 56) | ((uint64)HilbertIndex(U, V) << 32) | (uint32)i;
+	}
+
+	Algo::Sort(Keys);
+
+	OutOrder.SetNumUninitialized(Keys.Num());
+	for (int32 i = 0; i < Keys.Num(); i++)
+	{
+		OutOrder[i] = (int32)(Keys[i] & 0xFFFFFFFF);
+	}
+}
+
+void FPlanetMeshOrder::OptimizeTriangleOrder(TArrayView<const int32> Triangles, int32 NumVertices, int32 CacheSize, TArray<int32>& OutOrder)
+{
+	const int32 NumTriangles = Triangles.Num() / 3;
+	OutOrder.Reset(NumTriangles);
+
+	FMemMark Mark(FMemStack::Get());
+
+	// Triangles around each vertex, as ranges of one flat list
+	TArray<int32, TMemStackAllocator<>> AdjacencyOffsets;
+	AdjacencyOffsets.SetNumZeroed(NumVertices + 1);
+	for (int32 Index : Triangles)
+	{
+		AdjacencyOffsets[Index + 1]++;
+	}
+
+	for (int32 Vertex = 0; Vertex < NumVertices; Vertex++)
+	{
+		AdjacencyOffsets[Vertex + 1] += AdjacencyOffsets[Vertex];
+	}
+
+	TArray<int32, TMemStackAllocator<>> Adjacency;
+	Adjacency.SetNumUninitialized(Triangles.Num());
+	{
+		TArray<int32, TMemStackAllocator<>> Fill(AdjacencyOffsets.GetData(), NumVertices);
+		for (int32 i = 0; i < Triangles.Num(); i++)
+		{
+			Adjacency[Fill[Triangles[i]]++] = i / 3;
+		}
+	}
+
+	// Triangles by their lowest vertex, so clusters of consecutive triangles follow the vertex order
+	TArray<uint64, TMemStackAllocator<>> SortedTriangles;
+	SortedTriangles.SetNumUninitialized(NumTriangles);
+	for (int32 Tri = 0; Tri < NumTriangles; Tri++)
+	{
+		const int32 Lowest = FMath::Min3(Triangles[Tri * 3], Triangles[Tri * 3 + 1], Triangles[Tri * 3 + 2]);
+		SortedTriangles[Tri] = ((uint64)Lowest << 32) | (uint32)Tri;
+	}
+	Algo::Sort(SortedTriangles);
+
+	// Unemitted triangles of each vertex within the current cluster
+	TArray<int32, TMemStackAllocator<>> LiveTriangles;
+	LiveTriangles.SetNumZeroed(NumVertices);
+
+	TArray<int32, TMemStackAllocator<>> TriangleCluster;
+	TriangleCluster.SetNumUninitialized(NumTriangles);
+
+	// Time each vertex entered the simulated FIFO cache; a vertex is cached for CacheSize misses
+	TArray<int32, TMemStackAllocator<>> CacheTime;
+	CacheTime.SetNumZeroed(NumVertices);
+	int32 Time = CacheSize + 1;
+
+	TArray<bool, TMemStackAllocator<>> Emitted;
+	Emitted.SetNumZeroed(NumTriangles);
+
+	TArray<int32, TMemStackAllocator<>> DeadEnds;
+	TArray<int32, TMemStackAllocator<>> Candidates;
+
+	// Fanning over the whole mesh at once wanders across the surface and its working set outgrows
+	// the data cache, so the fans are confined to clusters that each cover a small patch
+	for (int32 ClusterStart = 0; ClusterStart < NumTriangles; ClusterStart += TrianglesPerCluster)
+	{
+		const int32 ClusterEnd = FMath::Min(ClusterStart + TrianglesPerCluster, NumTriangles);
+		for (int32 i = ClusterStart; i < ClusterEnd; i++)
+		{
+			const int32 Tri = (int32)(SortedTriangles[i] & 0xFFFFFFFF);
+			TriangleCluster[Tri] = ClusterStart;
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				LiveTriangles[Triangles[Tri * 3 + Corner]]++;
+			}
+		}
+
+		DeadEnds.Reset();
+		int32 Cursor = ClusterStart;
+		int32 Fanning = (int32)(SortedTriangles[ClusterStart] >> 32);
+		while (Fanning != INDEX_NONE)
+		{
+			// Emit the cluster's part of the fan around the vertex
+			Candidates.Reset();
+			for (int32 k = AdjacencyOffsets[Fanning]; k < AdjacencyOffsets[Fanning + 1]; k++)
+			{
+				const int32 Tri = Adjacency[k];
+				if (Emitted[Tri] || TriangleCluster[Tri] != ClusterStart)
+				{
+					continue;
+				}
+
+				Emitted[Tri] = true;
+				OutOrder.Add(Tri);
+
+				for (int32 Corner = 0; Corner < 3; Corner++)
+				{
+					const int32 Vertex = Triangles[Tri * 3 + Corner];
+					DeadEnds.Add(Vertex);
+					Candidates.Add(Vertex);
+					LiveTriangles[Vertex]--;
+
+					if (Time - CacheTime[Vertex] > CacheSize)
+					{
+						CacheTime[Vertex] = Time++;
+					}
+				}
+			}
+
+			// Continue from the fan vertex that will still be cached once its own fan is emitted,
+			// preferring the one that entered the cache first
+			Fanning = INDEX_NONE;
+			int32 BestPriority = -1;
+			for (int32 Vertex : Candidates)
+			{
+				if (LiveTriangles[Vertex] > 0)
+				{
+					const int32 Age = Time - CacheTime[Vertex];
+					const int32 Priority = Age + 2 * LiveTriangles[Vertex] <= CacheSize ? Age : 0;
+					if (Priority > BestPriority)
+					{
+						BestPriority = Priority;
+						Fanning = Vertex;
+					}
+				}
+			}
+
+			// Dead end: back track through recently used vertices, then take the lowest vertex of
+			// the next triangle in the cluster that is still waiting
+			while (Fanning == INDEX_NONE && DeadEnds.Num() > 0)
+			{
+				const int32 Vertex = DeadEnds.Pop(EAllowShrinking::No);
+				if (LiveTriangles[Vertex] > 0)
+				{
+					Fanning = Vertex;
+				}
+			}
+
+			for (; Fanning == INDEX_NONE && Cursor < ClusterEnd; Cursor++)
+			{
+				const int32 Tri = (int32)(SortedTriangles[Cursor] & 0xFFFFFFFF);
+				if (!Emitted[Tri])
+				{
+					Fanning = (int32)(SortedTriangles[Cursor] >> 32);
+				}
+			}
+		}
+	}
+}
+
+float FPlanetMeshOrder::ComputeACMR(TArrayView<const int32> Triangles, int32 NumVertices, int32 CacheSize)
+{
+	if (Triangles.Num() < 3)
+	{
+		return 0.0f;
+	}
+
+	FMemMark Mark(FMemStack::Get());
+
+	// Same FIFO model as OptimizeTriangleOrder: a vertex stays cached for CacheSize misses
+	TArray<int32, TMemStackAllocator<>> CacheTime;
+	CacheTime.SetNumZeroed(NumVertices);
+	int32 Time = CacheSize + 1;
+
+	int32 Misses = 0;
+	for (int32 Index : Triangles)
+	{
+		if (Time - CacheTime[Index] > CacheSize)
+		{
+			CacheTime[Index] = Time++;
+			Misses++;
+		}
+	}
+
+	return (float)Misses / (Triangles.Num() / 3);
+}
+
+float FPlanetMeshOrder::ComputeFetchMisses(TArrayView<const int32> Triangles, int32 VertexStride, int32 CacheLines)
+{
+	if (Triangles.Num() < 3)
+	{
+		return 0.0f;
+	}
+
+	constexpr int32 Ways = 8;
+	constexpr int64 LineBytes = 64;
+	const int32 Sets = FMath::Max(CacheLines / Ways, 1);
+
+	FMemMark Mark(FMemStack::Get());
+
+	// Line held by each way and when it was last used
+	TArray<int64, TMemStackAllocator<>> Tags;
+	TArray<uint32, TMemStackAllocator<>> LastUse;
+	Tags.Init(INDEX_NONE, Sets * Ways);
+	LastUse.SetNumZeroed(Sets * Ways);
+
+	uint32 Clock = 0;
+	int32 Misses = 0;
+	auto Touch = [&](int64 Line)
+	{
+		const int32 Base = (int32)(Line % Sets) * Ways;
+		int32 Victim = Base;
+		for (int32 Way = Base; Way < Base + Ways; Way++)
+		{
+			if (Tags[Way] == Line)
+			{
+				LastUse[Way] = ++Clock;
+				return;
+			}
+
+			if (LastUse[Way] < LastUse[Victim])
+			{
+				Victim = Way;
+			}
+		}
+
+		Tags[Victim] = Line;
+		LastUse[Victim] = ++Clock;
+		Misses++;
+	};
+
+	for (int32 Index : Triangles)
+	{
+		// A vertex that straddles two lines fetches both
+		const int64 First = (int64)Index * VertexStride / LineBytes;
+		const int64 Last = ((int64)Index * VertexStride + VertexStride - 1) / LineBytes;
+		for (int64 Line = First; Line <= Last; Line++)
+		{
+			Touch(Line);
+		}
+	}
+
+	return (float)Misses / (Triangles.Num() / 3);
+}
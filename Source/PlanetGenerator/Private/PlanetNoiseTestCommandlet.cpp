@@ -0,0 +1,84 @@
+#include "PlanetNoiseTestCommandlet.h"
+#include "SimplexNoiseBPLibrary.h"
+
+// Coordinates are drawn from [-BenchmarkExtent, BenchmarkExtent] so many lattice cells are covered
+static constexpr float BenchmarkExtent = 256.0f;
+
+static FVector4f RandomBenchmarkPoint(FRandomStream& Stream)
+{
+	return FVector4f(
+		Stream.FRandRange(-BenchmarkExtent, BenchmarkExtent),
+		Stream.FRandRange(-BenchmarkExtent, BenchmarkExtent),
+		Stream.FRandRange(-BenchmarkExtent, BenchmarkExtent),
+		Stream.FRandRange(-BenchmarkExtent, BenchmarkExtent));
+}
+
+// Times Function over all points; the sum keeps the optimiser from dropping the calls
+template <typename FunctionType>
+static void TimeScalar(const TCHAR* Name, const TArray<FVector4f>& Points, FunctionType Function)
+{
+	float Sum = 0.0f;
+	const double StartTime = FPlatformTime::Seconds();
+	for (const FVector4f& P : Points)
+	{
+		Sum += Function(P);
+	}
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogTemp, Display, TEXT("PlanetNoiseTest: %-12s scalar %7.2f ns/sample (checksum %f)"), Name, Seconds * 1e9 / Points.Num(), Sum);
+}
+
+static void RunBenchmarks(int32 NumSamples)
+{
+	FRandomStream Stream(64);
+	TArray<FVector4f> Points;
+	TArray<FVector> Points3D;
+	Points.SetNumUninitialized(NumSamples);
+	Points3D.SetNumUninitialized(NumSamples);
+	for (int32 i = 0; i < NumSamples; i++)
+	{
+		Points[i] = RandomBenchmarkPoint(Stream);
+		Points3D[i] = FVector(Points[i].X, Points[i].Y, Points[i].Z);
+	}
+
+	// Planet layers sample FBM with the default layer's octave count
+	constexpr int32 Octaves = 4;
+
+	TimeScalar(TEXT("1D"), Points, [](const FVector4f& P) { return USimplexNoiseBPLibrary::SimplexNoise1D(P.X); });
+	TimeScalar(TEXT("2D"), Points, [](const FVector4f& P) { return USimplexNoiseBPLibrary::SimplexNoise2D(P.X, P.Y); });
+	TimeScalar(TEXT("3D"), Points, [](const FVector4f& P) { return USimplexNoiseBPLibrary::SimplexNoise3D(P.X, P.Y, P.Z); });
+	TimeScalar(TEXT("4D"), Points, [](const FVector4f& P) { return USimplexNoiseBPLibrary::SimplexNoise4D(P.X, P.Y, P.Z, P.W); });
+	TimeScalar(TEXT("FBM"), Points, [](const FVector4f& P) { return USimplexNoiseBPLibrary::SimplexNoiseFBM(P.X, P.Y, P.Z, Octaves, 0.5f, 2.0f); });
+
+	TArray<float> Values;
+	Values.SetNumUninitialized(NumSamples);
+
+	double StartTime = FPlatformTime::Seconds();
+	USimplexNoiseBPLibrary::SimplexNoise3DBatch(Points3D, Values);
+	double Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogTemp, Display, TEXT("PlanetNoiseTest: %-12s batch  %7.2f ns/sample"), TEXT("3D"), Seconds * 1e9 / NumSamples);
+
+	StartTime = FPlatformTime::Seconds();
+	USimplexNoiseBPLibrary::SimplexNoiseFBMBatch(Points3D, Octaves, 0.5f, 2.0f, Values);
+	Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogTemp, Display, TEXT("PlanetNoiseTest: %-12s batch  %7.2f ns/sample"), TEXT("FBM"), Seconds * 1e9 / NumSamples);
+}
+
+UPlanetNoiseTestCommandlet::UPlanetNoiseTestCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UPlanetNoiseTestCommandlet::Main(const FString& Params)
+{
+	int32 NumSamples = 1000000;
+	FParse::Value(*Params, TEXT("Samples="), NumSamples);
+	NumSamples = FMath::Max(NumSamples, 1);
+
+	USimplexNoiseBPLibrary::SetNoiseSeed(USimplexNoiseBPLibrary::DefaultSeed);
+	RunBenchmarks(NumSamples);
+	return 0;
+}
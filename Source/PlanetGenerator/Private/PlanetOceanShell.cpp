@@ -0,0 +1,96 @@
+#include "PlanetOceanShell.h"
+#include "Misc/ScopeLock.h"
+
+TSharedRef<const FPlanetOceanShell> FPlanetOceanShell::Get(int32 Resolution)
+{
+	static FCriticalSection CacheLock;
+	static TMap<int32, TSharedRef<const FPlanetOceanShell>> Cache;
+
+	Resolution = FMath::Clamp(Resolution, 0, 6);
+
+	FScopeLock Lock(&CacheLock);
+	if (const TSharedRef<const FPlanetOceanShell>* Existing = Cache.Find(Resolution))
+	{
+		return *Existing;
+	}
+
+	TSharedRef<FPlanetOceanShell> Shell = MakeShared<FPlanetOceanShell>();
+	Shell->Build(Resolution);
+	Cache.Add(Resolution, Shell);
+	return Shell;
+}
+
+void FPlanetOceanShell::Build(int32 Resolution)
+{
+	// Same icosahedron and winding as FPlanetMeshBuilder::CreateIcosphere
+	const float t = (1.0f + FMath::Sqrt(5.0f)) / 2.0f;
+	const FVector Corners[12] =
+	{
+		FVector(-1, t, 0), FVector(1, t, 0), FVector(-1, -t, 0), FVector(1, -t, 0),
+		FVector(0, -1, t), FVector(0, 1, t), FVector(0, -1, -t), FVector(0, 1, -t),
+		FVector(t, 0, -1), FVector(t, 0, 1), FVector(-t, 0, -1), FVector(-t, 0, 1)
+	};
+	const int32 Faces[60] =
+	{
+		0, 5, 11,  0, 1, 5,  0, 7, 1,  0, 10, 7,  0, 11, 10,
+		1, 9, 5,  5, 4, 11,  11, 2, 10,  10, 6, 7,  7, 8, 1,
+		3, 4, 9,  3, 2, 4,  3, 6, 2,  3, 8, 6,  3, 9, 8,
+		4, 5, 9,  2, 11, 4,  6, 10, 2,  8, 7, 6,  9, 1, 8
+	};
+
+	for (const FVector& Corner : Corners)
+	{
+		Positions.Add(Corner.GetSafeNormal());
+	}
+	Triangles.Append(Faces, UE_ARRAY_COUNT(Faces));
+
+	// The shell is small, so midpoints are simply shared through an edge map
+	TMap<uint64, int32> Midpoints;
+	auto GetMidpoint = [this, &Midpoints](int32 A, int32 B)
+	{
+		const uint64 Key = ((uint64)FMath::Min(A, B) << 32) | (uint64)FMath::Max(A, B);
+		if (const int32* Existing = Midpoints.Find(Key))
+		{
+			return *Existing;
+		}
+		const int32 Index = Positions.Add(((Positions[A] + Positions[B]) * 0.5f).GetSafeNormal());
+		Midpoints.Add(Key, Index);
+		return Index;
+	};
+
+	for (int32 i = 0; i < Resolution; i++)
+	{
+		TArray<int32> NewTriangles;
+		NewTriangles.Reserve(Triangles.Num() * 4);
+		Midpoints.Reset();
+
+		for (int32 j = 0; j < Triangles.Num(); j += 3)
+		{
+			const int32 v1 = Triangles[j];
+			const int32 v2 = Triangles[j + 1];
+			const int32 v3 = Triangles[j + 2];
+			const int32 a = GetMidpoint(v1, v2);
+			const int32 b = GetMidpoint(v2, v3);
+			const int32 c = GetMidpoint(v3, v1);
+
+			NewTriangles.Append({ v1, a, c, v2, b, a, v3, c, b, a, b, c });
+		}
+
+		Triangles = MoveTemp(NewTriangles);
+	}
+
+	UVs.SetNum(Positions.Num());
+	for (int32 i = 0; i < Positions.Num(); i++)
+	{
+		const FVector& P = Positions[i];
+		UVs[i] = FVector2D(0.5f + FMath::Atan2(P.Y, P.X) / (2.0f * PI), 0.5f - FMath::Asin(P.Z) / PI);
+	}
+
+	InscribedRadius = 1.0f;
+	for (int32 j = 0; j < Triangles.Num(); j += 3)
+	{
+		const FVector& A = Positions[Triangles[j]];
+		const FVector Normal = FVector::CrossProduct(Positions[Triangles[j + 1]] - A, Positions[Triangles[j + 2]] - A).GetSafeNormal();
+		InscribedRadius = FMath::Min(InscribedRadius, FMath::Abs(FVector::DotProduct(Normal, A)));
+	}
+}
@@ -0,0 +1,255 @@
+#include "PlanetPathfinding.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Reverse.h"
+
+float FPlanetPathCosts::GetMinPassableCost() const
+{
+	float MinCost = MAX_FLT;
+	for (float Cost : BiomeCosts)
+	{
+		if (Cost > 0.0f)
+		{
+			MinCost = FMath::Min(MinCost, Cost);
+		}
+	}
+
+	return MinCost < MAX_FLT ? MinCost : 1.0f;
+}
+
+// Per-search state; stamps let the arrays be reused without clearing them between searches
+struct FPlanetPathfinder::FSearchScratch
+{
+	struct FOpenNode
+	{
+		float F;
+		int32 Tile;
+
+		bool operator<(const FOpenNode& Other) const { return F < Other.F; }
+	};
+
+	TArray<float> GScore;
+	TArray<int32> Parent;
+	TArray<uint32> SeenStamp;
+	TArray<uint32> ClosedStamp;
+	TArray<FOpenNode> OpenHeap;
+	uint32 Stamp = 0;
+
+	void Begin(int32 NumTiles)
+	{
+		if (SeenStamp.Num() != NumTiles)
+		{
+			GScore.SetNumUninitialized(NumTiles);
+			Parent.SetNumUninitialized(NumTiles);
+			SeenStamp.SetNumZeroed(NumTiles);
+			ClosedStamp.SetNumZeroed(NumTiles);
+			Stamp = 0;
+		}
+
+		// On wrap-around the stamps are no longer unique, so start over
+		if (++Stamp == 0)
+		{
+			FMemory::Memzero(SeenStamp.GetData(), SeenStamp.Num() * sizeof(uint32));
+			FMemory::Memzero(ClosedStamp.GetData(), ClosedStamp.Num() * sizeof(uint32));
+			Stamp = 1;
+		}
+
+		OpenHeap.Reset();
+	}
+};
+
+FPlanetPathfinder::FPlanetPathfinder(TSharedPtr<const FPlanetTileGraph> InTileGraph, TSharedPtr<const FPlanetTileAttributes> InAttributes, float InPlanetRadius)
+{
+	Build(InTileGraph, InAttributes, InPlanetRadius);
+}
+
+void FPlanetPathfinder::Build(TSharedPtr<const FPlanetTileGraph> InTileGraph, TSharedPtr<const FPlanetTileAttributes> InAttributes, float InPlanetRadius)
+{
+	Reset();
+	TileGraph = InTileGraph;
+	Attributes = InAttributes;
+	PlanetRadius = InPlanetRadius;
+
+	if (!TileGraph.IsValid() || !Attributes.IsValid())
+	{
+		TileGraph.Reset();
+		return;
+	}
+
+	const int32 NumTiles = TileGraph->GetNumTiles();
+	check(Attributes->GetNumTiles() == NumTiles);
+
+	EdgeLengths.SetNumUninitialized(TileGraph->TileNeighbours.Num());
+	for (int32 Tile = 0; Tile < NumTiles; Tile++)
+	{
+		for (int32 Edge = TileGraph->TileOffsets[Tile]; Edge < TileGraph->TileOffsets[Tile + 1]; Edge++)
+		{
+			EdgeLengths[Edge] = GreatCircleDistance(Tile, TileGraph->TileNeighbours[Edge]);
+		}
+	}
+}
+
+void FPlanetPathfinder::Reset()
+{
+	TileGraph.Reset();
+	Attributes.Reset();
+	EdgeLengths.Reset();
+}
+
+FPlanetPathfinder::~FPlanetPathfinder()
+{
+	for (FSearchScratch* Scratch : ScratchPool)
+	{
+		delete Scratch;
+	}
+}
+
+SIZE_T FPlanetPathfinder::GetAllocatedSize() const
+{
+	SIZE_T Size = EdgeLengths.GetAllocatedSize();
+
+	FScopeLock Lock(&ScratchLock);
+	Size += ScratchPool.GetAllocatedSize();
+	for (const FSearchScratch* Scratch : ScratchPool)
+	{
+		Size += sizeof(FSearchScratch) + Scratch->GScore.GetAllocatedSize() + Scratch->Parent.GetAllocatedSize()
+			+ Scratch->SeenStamp.GetAllocatedSize() + Scratch->ClosedStamp.GetAllocatedSize() + Scratch->OpenHeap.GetAllocatedSize();
+	}
+	return Size;
+}
+
+float FPlanetPathfinder::GreatCircleDistance(int32 TileA, int32 TileB) const
+{
+	float CosAngle = FVector::DotProduct(TileGraph->TileCenters[TileA], TileGraph->TileCenters[TileB]);
+	return PlanetRadius * FMath::Acos(FMath::Clamp(CosAngle, -1.0f, 1.0f));
+}
+
+FPlanetPathfinder::FSearchScratch* FPlanetPathfinder::AcquireScratch() const
+{
+	{
+		FScopeLock Lock(&ScratchLock);
+		if (ScratchPool.Num() > 0)
+		{
+			return ScratchPool.Pop(EAllowShrinking::No);
+		}
+	}
+
+	return new FSearchScratch();
+}
+
+void FPlanetPathfinder::ReleaseScratch(FSearchScratch* Scratch) const
+{
+	FScopeLock Lock(&ScratchLock);
+	ScratchPool.Add(Scratch);
+}
+
+bool FPlanetPathfinder::FindPath(int32 StartTile, int32 GoalTile, const FPlanetPathCosts& Costs, FPlanetPathResult& OutResult) const
+{
+	OutResult = FPlanetPathResult();
+
+	if (!TileGraph.IsValid() || !TileGraph->IsValidTile(StartTile) || !TileGraph->IsValidTile(GoalTile))
+	{
+		return false;
+	}
+
+	const TArray<float>& TileHeights = Attributes->TileHeights;
+	const TArray<uint8>& TileBiomes = Attributes->TileBiomes;
+
+	if (Costs.BiomeCosts[TileBiomes[StartTile]] <= 0.0f || Costs.BiomeCosts[TileBiomes[GoalTile]] <= 0.0f)
+	{
+		return false;
+	}
+
+	// Every step costs at least its great-circle length times the cheapest biome, which keeps the heuristic admissible
+	const float HeuristicScale = Costs.GetMinPassableCost();
+	const float HeightToWorld = PlanetRadius * 0.2f;
+
+	FSearchScratch* Scratch = AcquireScratch();
+	Scratch->Begin(TileGraph->GetNumTiles());
+	const uint32 Stamp = Scratch->Stamp;
+
+	Scratch->GScore[StartTile] = 0.0f;
+	Scratch->Parent[StartTile] = INDEX_NONE;
+	Scratch->SeenStamp[StartTile] = Stamp;
+	Scratch->OpenHeap.HeapPush({ GreatCircleDistance(StartTile, GoalTile) * HeuristicScale, StartTile });
+
+	bool bFound = false;
+	while (Scratch->OpenHeap.Num() > 0)
+	{
+		FSearchScratch::FOpenNode Node;
+		Scratch->OpenHeap.HeapPop(Node, EAllowShrinking::No);
+
+		const int32 Current = Node.Tile;
+		if (Scratch->ClosedStamp[Current] == Stamp)
+		{
+			continue;
+		}
+		Scratch->ClosedStamp[Current] = Stamp;
+
+		if (Current == GoalTile)
+		{
+			bFound = true;
+			break;
+		}
+
+		for (int32 Edge = TileGraph->TileOffsets[Current]; Edge < TileGraph->TileOffsets[Current + 1]; Edge++)
+		{
+			const int32 Neighbour = TileGraph->TileNeighbours[Edge];
+			const float BiomeCost = Costs.BiomeCosts[TileBiomes[Neighbour]];
+			if (BiomeCost <= 0.0f || Scratch->ClosedStamp[Neighbour] == Stamp)
+			{
+				continue;
+			}
+
+			// Slope penalty: height difference in world units over the step length
+			const float Length = EdgeLengths[Edge];
+			const float Climb = FMath::Abs(TileHeights[Neighbour] - TileHeights[Current]) * HeightToWorld;
+			const float Slope = Length > SMALL_NUMBER ? Climb / Length : 0.0f;
+			const float Tentative = Scratch->GScore[Current] + Length * BiomeCost * (1.0f + Costs.ElevationCostScale * Slope);
+
+			if (Scratch->SeenStamp[Neighbour] != Stamp || Tentative < Scratch->GScore[Neighbour])
+			{
+				Scratch->SeenStamp[Neighbour] = Stamp;
+				Scratch->GScore[Neighbour] = Tentative;
+				Scratch->Parent[Neighbour] = Current;
+				Scratch->OpenHeap.HeapPush({ Tentative + GreatCircleDistance(Neighbour, GoalTile) * HeuristicScale, Neighbour });
+			}
+		}
+	}
+
+	if (bFound)
+	{
+		OutResult.bFound = true;
+		OutResult.Cost = Scratch->GScore[GoalTile];
+		for (int32 Tile = GoalTile; Tile != INDEX_NONE; Tile = Scratch->Parent[Tile])
+		{
+			OutResult.Tiles.Add(Tile);
+		}
+		Algo::Reverse(OutResult.Tiles);
+	}
+
+	ReleaseScratch(Scratch);
+	return bFound;
+}
+
+void FPlanetPathfinder::FindPathsAsync(TArray<FPlanetPathQuery> Queries, const FPlanetPathCosts& Costs, TFunction<void(TArray<FPlanetPathResult>&&)> OnComplete) const
+{
+	// Keep the pathfinder alive until the batch is done, even if the planet regenerates meanwhile
+	TSharedRef<const FPlanetPathfinder> Self = AsShared();
+
+	Async(EAsyncExecution::ThreadPool, [Self, Queries = MoveTemp(Queries), Costs, OnComplete = MoveTemp(OnComplete)]() mutable
+	{
+		TArray<FPlanetPathResult> Results;
+		Results.SetNum(Queries.Num());
+
+		ParallelFor(Queries.Num(), [&](int32 Index)
+		{
+			Self->FindPath(Queries[Index].StartTile, Queries[Index].GoalTile, Costs, Results[Index]);
+		});
+
+		AsyncTask(ENamedThreads::GameThread, [Results = MoveTemp(Results), OnComplete = MoveTemp(OnComplete)]() mutable
+		{
+			OnComplete(MoveTemp(Results));
+		});
+	});
+}
@@ -0,0 +1,203 @@
+#include "PlanetSpatialIndex.h"
+
+void FPlanetSpatialIndex::Reset()
+{
+	TileGraph.Reset();
+	GridSize = 1;
+	CellTiles.Reset();
+	MaxNeighbourAngle = 0.0f;
+}
+
+FPlanetSpatialIndex::FPlanetSpatialIndex(TSharedPtr<const FPlanetTileGraph> InTileGraph)
+{
+	Build(InTileGraph);
+}
+
+void FPlanetSpatialIndex::Build(TSharedPtr<const FPlanetTileGraph> InTileGraph)
+{
+	Reset();
+	TileGraph = InTileGraph;
+
+	if (!TileGraph.IsValid() || TileGraph->GetNumTiles() == 0)
+	{
+		return;
+	}
+
+	const int32 NumTiles = TileGraph->GetNumTiles();
+	const TArray<FVector>& Centers = TileGraph->TileCenters;
+
+	// Roughly one tile per cell
+	GridSize = FMath::Max(1, FMath::RoundToInt(FMath::Sqrt(NumTiles / 6.0f)));
+
+	auto GetCellCenter = [this](int32 Cell) -> FVector
+	{
+		const int32 Face = Cell / (GridSize * GridSize);
+		const int32 X = Cell % GridSize;
+		const int32 Y = (Cell / GridSize) % GridSize;
+		return CubeFaceToDirection(Face, (X + 0.5f) / GridSize, (Y + 0.5f) / GridSize);
+	};
+
+	CellTiles.Init(INDEX_NONE, 6 * GridSize * GridSize);
+	TArray<float> CellBestDot;
+	CellBestDot.Init(-2.0f, CellTiles.Num());
+
+	for (int32 Tile = 0; Tile < NumTiles; Tile++)
+	{
+		const int32 Cell = GetCellIndex(Centers[Tile]);
+		const float Dot = FVector::DotProduct(Centers[Tile], GetCellCenter(Cell));
+		if (Dot > CellBestDot[Cell])
+		{
+			CellBestDot[Cell] = Dot;
+			CellTiles[Cell] = Tile;
+		}
+
+		for (int32 Neighbour : TileGraph->GetTileNeighbours(Tile))
+		{
+			float CosAngle = FMath::Clamp(FVector::DotProduct(Centers[Tile], Centers[Neighbour]), -1.0f, 1.0f);
+			MaxNeighbourAngle = FMath::Max(MaxNeighbourAngle, FMath::Acos(CosAngle));
+		}
+	}
+
+	// Cells no tile centre fell into start from the nearest tile to their centre
+	for (int32 Cell = 0; Cell < CellTiles.Num(); Cell++)
+	{
+		if (CellTiles[Cell] == INDEX_NONE)
+		{
+			CellTiles[Cell] = 0;
+			CellTiles[Cell] = FindNearestTile(GetCellCenter(Cell));
+		}
+	}
+}
+
+int32 FPlanetSpatialIndex::DirectionToCubeFace(const FVector& Direction, float& OutU, float& OutV)
+{
+	const FVector Abs = Direction.GetAbs();
+
+	int32 Face;
+	float Major, A, B;
+	if (Abs.X >= Abs.Y && Abs.X >= Abs.Z)
+	{
+		Face = Direction.X >= 0.0f ? 0 : 1;
+		Major = Abs.X; A = Direction.Y; B = Direction.Z;
+	}
+	else if (Abs.Y >= Abs.Z)
+	{
+		Face = Direction.Y >= 0.0f ? 2 : 3;
+		Major = Abs.Y; A = Direction.X; B = Direction.Z;
+	}
+	else
+	{
+		Face = Direction.Z >= 0.0f ? 4 : 5;
+		Major = Abs.Z; A = Direction.X; B = Direction.Y;
+	}
+
+	if (Major < SMALL_NUMBER)
+	{
+		OutU = 0.5f;
+		OutV = 0.5f;
+		return 0;
+	}
+
+	OutU = FMath::Clamp(0.5f * (A / Major + 1.0f), 0.0f, 1.0f);
+	OutV = FMath::Clamp(0.5f * (B / Major + 1.0f), 0.0f, 1.0f);
+	return Face;
+}
+
+FVector FPlanetSpatialIndex::CubeFaceToDirection(int32 Face, float U, float V)
+{
+	const float Sign = (Face & 1) ? -1.0f : 1.0f;
+	const float A = U * 2.0f - 1.0f;
+	const float B = V * 2.0f - 1.0f;
+
+	switch (Face >> 1)
+	{
+	case 0: return FVector(Sign, A, B).GetSafeNormal();
+	case 1: return FVector(A, Sign, B).GetSafeNormal();
+	default: return FVector(A, B, Sign).GetSafeNormal();
+	}
+}
+
+int32 FPlanetSpatialIndex::GetCellIndex(const FVector& Direction) const
+{
+	float U, V;
+	const int32 Face = DirectionToCubeFace(Direction, U, V);
+	const int32 X = FMath::Min(FMath::FloorToInt(U * GridSize), GridSize - 1);
+	const int32 Y = FMath::Min(FMath::FloorToInt(V * GridSize), GridSize - 1);
+	return (Face * GridSize + Y) * GridSize + X;
+}
+
+int32 FPlanetSpatialIndex::FindNearestTile(const FVector& Direction) const
+{
+	if (CellTiles.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const FVector Target = Direction.GetSafeNormal();
+	const TArray<FVector>& Centers = TileGraph->TileCenters;
+
+	int32 Current = CellTiles[GetCellIndex(Target)];
+	float CurrentDot = FVector::DotProduct(Centers[Current], Target);
+
+	// Greedy walk towards the target; a two-ring check guards against stopping on a local maximum
+	bool bImproved = true;
+	while (bImproved)
+	{
+		bImproved = false;
+		for (int32 Neighbour : TileGraph->GetTileNeighbours(Current))
+		{
+			const float Dot = FVector::DotProduct(Centers[Neighbour], Target);
+			if (Dot > CurrentDot)
+			{
+				Current = Neighbour;
+				CurrentDot = Dot;
+				bImproved = true;
+			}
+
+			for (int32 Second : TileGraph->GetTileNeighbours(Neighbour))
+			{
+				const float SecondDot = FVector::DotProduct(Centers[Second], Target);
+				if (SecondDot > CurrentDot)
+				{
+					Current = Second;
+					CurrentDot = SecondDot;
+					bImproved = true;
+				}
+			}
+
+			if (bImproved)
+			{
+				break;
+			}
+		}
+	}
+
+	return Current;
+}
+
+void FPlanetSpatialIndex::GetTilesInCap(const FVector& Direction, float AngleRadians, TArray<int32>& OutTiles) const
+{
+	OutTiles.Reset();
+
+	if (CellTiles.Num() == 0 || AngleRadians < 0.0f)
+	{
+		return;
+	}
+
+	const FVector Target = Direction.GetSafeNormal();
+	const TArray<FVector>& Centers = TileGraph->TileCenters;
+	const float CosLimit = FMath::Cos(FMath::Min(AngleRadians, PI));
+
+	// Grow through a slightly larger cap so tiles reachable only across the rim are not missed
+	const float CosGrow = FMath::Cos(FMath::Min(AngleRadians + MaxNeighbourAngle, PI));
+
+	TileGraph->FloodFill(FindNearestTile(Target), [&](int32 Tile)
+	{
+		return FVector::DotProduct(Centers[Tile], Target) >= CosGrow;
+	}, OutTiles);
+
+	OutTiles.RemoveAll([&](int32 Tile)
+	{
+		return FVector::DotProduct(Centers[Tile], Target) < CosLimit;
+	});
+}
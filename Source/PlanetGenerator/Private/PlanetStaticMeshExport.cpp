@@ -0,0 +1,168 @@
+#include "PlanetStaticMeshExport.h"
+
+#if WITH_EDITOR
+
+#include "PlanetTileAttributes.h"
+#include "Engine/StaticMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "Misc/PackageName.h"
+
+static void BuildPlanetMeshDescription(const FPlanetStaticMeshSource& Source, FMeshDescription& OutMeshDescription)
+{
+	FStaticMeshAttributes MeshAttributes(OutMeshDescription);
+	MeshAttributes.Register();
+
+	TVertexAttributesRef<FVector3f> VertexPositions = MeshAttributes.GetVertexPositions();
+	TVertexInstanceAttributesRef<FVector3f> InstanceNormals = MeshAttributes.GetVertexInstanceNormals();
+	TVertexInstanceAttributesRef<FVector3f> InstanceTangents = MeshAttributes.GetVertexInstanceTangents();
+	TVertexInstanceAttributesRef<float> InstanceBinormalSigns = MeshAttributes.GetVertexInstanceBinormalSigns();
+	TVertexInstanceAttributesRef<FVector4f> InstanceColors = MeshAttributes.GetVertexInstanceColors();
+	TVertexInstanceAttributesRef<FVector2f> InstanceUVs = MeshAttributes.GetVertexInstanceUVs();
+	TPolygonGroupAttributesRef<FName> MaterialSlotNames = MeshAttributes.GetPolygonGroupMaterialSlotNames();
+
+	const FPlanetTileAttributes* Climate = Source.Attributes;
+	const bool bHasClimate = Climate && Climate->GetNumVertices() == Source.Positions.Num();
+	InstanceUVs.SetNumChannels(bHasClimate ? 3 : 1);
+
+	const int32 NumVertices = Source.Positions.Num();
+	OutMeshDescription.ReserveNewVertices(NumVertices);
+	OutMeshDescription.ReserveNewVertexInstances(NumVertices);
+	OutMeshDescription.ReserveNewTriangles(Source.Triangles.Num() / 3);
+
+	// Vertices are shared between triangles on the sphere, so one instance per vertex keeps the mesh welded
+	TArray<FVertexInstanceID> Instances;
+	Instances.SetNumUninitialized(NumVertices);
+	for (int32 i = 0; i < NumVertices; i++)
+	{
+		const FVertexID Vertex = OutMeshDescription.CreateVertex();
+		VertexPositions[Vertex] = FVector3f(Source.Positions[i]);
+
+		const FVertexInstanceID Instance = OutMeshDescription.CreateVertexInstance(Vertex);
+		Instances[i] = Instance;
+
+		InstanceNormals[Instance] = Source.Normals.IsValidIndex(i) ? FVector3f(Source.Normals[i]) : FVector3f(Source.Positions[i].GetSafeNormal());
+		if (Source.Tangents.IsValidIndex(i))
+		{
+			InstanceTangents[Instance] = FVector3f(Source.Tangents[i].TangentX);
+			InstanceBinormalSigns[Instance] = Source.Tangents[i].bFlipTangentY ? -1.0f : 1.0f;
+		}
+		InstanceColors[Instance] = Source.VertexColors.IsValidIndex(i) ? FVector4f(Source.VertexColors[i]) : FVector4f(1.0f, 1.0f, 1.0f, 1.0f);
+		InstanceUVs.Set(Instance, 0, Source.UV0.IsValidIndex(i) ? FVector2f(Source.UV0[i]) : FVector2f::ZeroVector);
+
+		if (bHasClimate)
+		{
+			InstanceUVs.Set(Instance, 1, FVector2f((float)Climate->VertexBiomes[i], Climate->VertexHeights[i]));
+			InstanceUVs.Set(Instance, 2, FVector2f(Climate->VertexTemperatures[i], Climate->VertexMoistures[i]));
+		}
+	}
+
+	const FPolygonGroupID PolygonGroup = OutMeshDescription.CreatePolygonGroup();
+	MaterialSlotNames[PolygonGroup] = FName("Planet");
+
+	for (int32 i = 0; i + 2 < Source.Triangles.Num(); i += 3)
+	{
+		const FVertexInstanceID Corners[3] = { Instances[Source.Triangles[i]], Instances[Source.Triangles[i + 1]], Instances[Source.Triangles[i + 2]] };
+		OutMeshDescription.CreateTriangle(PolygonGroup, Corners);
+	}
+}
+
+UStaticMesh* FPlanetStaticMeshExporter::Export(const FPlanetStaticMeshSource& Source, const FPlanetStaticMeshExportSettings& Settings)
+{
+	if (Source.Positions.Num() == 0 || Source.Triangles.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPlanetStaticMeshExporter: Planet has no generated mesh"));
+		return nullptr;
+	}
+
+	if (!FPackageName::IsValidLongPackageName(Settings.PackageName))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPlanetStaticMeshExporter: Invalid package name %s"), *Settings.PackageName);
+		return nullptr;
+	}
+
+	UPackage* Package = CreatePackage(*Settings.PackageName);
+	const FName AssetName(*FPackageName::GetLongPackageAssetName(Settings.PackageName));
+
+	// Re-baking overwrites the previous asset in place, so level references stay valid
+	UStaticMesh* StaticMesh = FindObject<UStaticMesh>(Package, *AssetName.ToString());
+	if (StaticMesh)
+	{
+		StaticMesh->Modify();
+		StaticMesh->SetNumSourceModels(0);
+		StaticMesh->GetStaticMaterials().Reset();
+	}
+	else
+	{
+		StaticMesh = NewObject<UStaticMesh>(Package, AssetName, RF_Public | RF_Standalone);
+	}
+
+	FMeshDescription MeshDescription;
+	BuildPlanetMeshDescription(Source, MeshDescription);
+
+	const int32 NumLODs = FMath::Clamp(Settings.NumLODs, 1, MAX_STATIC_MESH_LODS);
+	for (int32 LODIndex = 0; LODIndex < NumLODs; LODIndex++)
+	{
+		FStaticMeshSourceModel& SourceModel = StaticMesh->AddSourceModel();
+
+		// The planet already carries its own normals and tangents
+		SourceModel.BuildSettings.bRecomputeNormals = false;
+		SourceModel.BuildSettings.bRecomputeTangents = false;
+		SourceModel.BuildSettings.bUseMikkTSpace = false;
+		SourceModel.BuildSettings.bRemoveDegenerates = true;
+
+		// Generated lightmap UVs would be written over the climate data in UV1
+		SourceModel.BuildSettings.bGenerateLightmapUVs = false;
+
+		if (LODIndex > 0)
+		{
+			SourceModel.ReductionSettings.PercentTriangles = FMath::Pow(0.5f, (float)LODIndex);
+		}
+	}
+
+	// Only LOD 0 has a description; the other levels are reduced from it at build time
+	StaticMesh->CreateMeshDescription(0, MoveTemp(MeshDescription));
+	StaticMesh->CommitMeshDescription(0);
+
+	StaticMesh->GetStaticMaterials().Add(FStaticMaterial(Source.Material, FName("Planet"), FName("Planet")));
+
+	// Static lighting uses the spherical mapping rather than the climate channels
+	StaticMesh->SetLightMapCoordinateIndex(0);
+
+	FMeshNaniteSettings NaniteSettings = StaticMesh->NaniteSettings;
+	NaniteSettings.bEnabled = Settings.bEnableNanite;
+	StaticMesh->NaniteSettings = NaniteSettings;
+
+	StaticMesh->CreateBodySetup();
+	UBodySetup* BodySetup = StaticMesh->GetBodySetup();
+	BodySetup->CollisionTraceFlag = Settings.bGenerateCollision ? CTF_UseComplexAsSimple : CTF_UseSimpleAsComplex;
+	if (!Settings.bGenerateCollision)
+	{
+		BodySetup->DefaultInstance.SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	}
+
+	StaticMesh->Build(false);
+	StaticMesh->PostEditChange();
+	StaticMesh->MarkPackageDirty();
+	FAssetRegistryModule::AssetCreated(StaticMesh);
+
+	if (Settings.bSavePackage)
+	{
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		const FString Filename = FPackageName::LongPackageNameToFilename(Settings.PackageName, FPackageName::GetAssetPackageExtension());
+		if (!UPackage::SavePackage(Package, StaticMesh, *Filename, SaveArgs))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FPlanetStaticMeshExporter: Failed to save %s"), *Filename);
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Baked planet to %s with %d vertices, %d triangles and %d LODs"), *Settings.PackageName, Source.Positions.Num(), Source.Triangles.Num() / 3, NumLODs);
+	return StaticMesh;
+}
+
+#endif
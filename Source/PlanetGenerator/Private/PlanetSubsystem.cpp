@@ -0,0 +1,463 @@
+#include "PlanetSubsystem.h"
+#include "PlanetActor.h"
+#include "PlanetMeshBuilder.h"
+#include "PlanetGeneratorSettings.h"
+#include "PlanetCalibration.h"
+#include "Async/Async.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+
+void UPlanetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Measured once per machine on a worker; queued planets wait for it in TickGeneration
+	if (GetDefault<UPlanetGeneratorSettings>()->bAutoCalibrate)
+	{
+		UPlanetCalibration::EnsureCalibrated();
+	}
+}
+
+void UPlanetSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TickGeneration();
+	TickMemoryGovernor(DeltaTime);
+	TickImpostors();
+
+	for (int32 i = Planets.Num() - 1; i >= 0; i--)
+	{
+		APlanetActor* Planet = Planets[i].Get();
+		USceneComponent* Root = Planet ? Planet->GetRootComponent() : nullptr;
+		if (!Root)
+		{
+			Planets.RemoveAtSwap(i);
+			Motions.RemoveAtSwap(i);
+			continue;
+		}
+
+		FPlanetMotion& Motion = Motions[i];
+
+		FQuat Rotation = Root->GetComponentQuat();
+		if (Motion.RotationSpeed != 0.0f)
+		{
+			Rotation = Rotation * FQuat(Motion.RotationAxis, Motion.RotationSpeed * DeltaTime);
+		}
+
+		FVector Location = Root->GetComponentLocation();
+		if (Motion.bOrbit)
+		{
+			Motion.OrbitAngle = FMath::Fmod(Motion.OrbitAngle + Motion.OrbitSpeed * DeltaTime, 2.0f * PI);
+			Location = Motion.OrbitCenter + FQuat(Motion.OrbitAxis, Motion.OrbitAngle).RotateVector(Motion.OrbitOffset);
+		}
+
+		Root->SetWorldLocationAndRotation(Location, Rotation);
+	}
+}
+
+TStatId UPlanetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPlanetSubsystem, STATGROUP_Tickables);
+}
+
+bool UPlanetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// Planets only move in play, like the actor tick this replaces
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UPlanetSubsystem::UpdatePlanet(APlanetActor* Planet)
+{
+	if (!Planet)
+	{
+		return;
+	}
+
+	const bool bRotate = Planet->AutoRotate && Planet->RotationSpeed != 0.0f && !Planet->RotationAxis.IsNearlyZero();
+	const bool bOrbit = Planet->AutoOrbit && Planet->OrbitSpeed != 0.0f && !Planet->OrbitAxis.IsNearlyZero();
+
+	int32 Index = Planets.IndexOfByKey(Planet);
+	if (!bRotate && !bOrbit)
+	{
+		if (Index != INDEX_NONE)
+		{
+			Planets.RemoveAtSwap(Index);
+			Motions.RemoveAtSwap(Index);
+		}
+		return;
+	}
+
+	if (Index == INDEX_NONE)
+	{
+		Index = Planets.Add(Planet);
+		Motions.AddDefaulted();
+	}
+
+	FPlanetMotion& Motion = Motions[Index];
+	Motion.RotationAxis = Planet->RotationAxis.GetSafeNormal();
+	Motion.RotationSpeed = bRotate ? FMath::DegreesToRadians(Planet->RotationSpeed) : 0.0f;
+
+	// The orbit keeps the planet's current distance from the centre, starting where it stands
+	const FVector OrbitCenter = Planet->OrbitCenter;
+	const FVector OrbitAxis = Planet->OrbitAxis.GetSafeNormal();
+	if (bOrbit && (!Motion.bOrbit || Motion.OrbitCenter != OrbitCenter || Motion.OrbitAxis != OrbitAxis))
+	{
+		Motion.OrbitOffset = Planet->GetActorLocation() - OrbitCenter;
+		Motion.OrbitAngle = 0.0f;
+	}
+
+	Motion.bOrbit = bOrbit;
+	Motion.OrbitCenter = OrbitCenter;
+	Motion.OrbitAxis = OrbitAxis;
+	Motion.OrbitSpeed = bOrbit ? FMath::DegreesToRadians(Planet->OrbitSpeed) : 0.0f;
+}
+
+void UPlanetSubsystem::RemovePlanet(APlanetActor* Planet)
+{
+	const int32 Index = Planets.IndexOfByKey(Planet);
+	if (Index != INDEX_NONE)
+	{
+		Planets.RemoveAtSwap(Index);
+		Motions.RemoveAtSwap(Index);
+	}
+
+	CancelGeneration(Planet);
+	ImpostorPlanets.Remove(Planet);
+}
+
+void UPlanetSubsystem::CancelGeneration(APlanetActor* Planet)
+{
+	// Running builds of the planet are dropped when they finish
+	LatestRequests.Remove(Planet);
+	QueuedBuilds.RemoveAll([Planet](const FPlanetBuildJob& Job) { return Job.Planet == Planet; });
+}
+
+void UPlanetSubsystem::RequestGeneration(APlanetActor* Planet)
+{
+	if (!Planet)
+	{
+		return;
+	}
+
+	const uint32 RequestId = NextRequestId++;
+	LatestRequests.Add(Planet, RequestId);
+
+	// A queued request has not taken its settings snapshot yet, so it already covers this one
+	if (FPlanetBuildJob* Queued = QueuedBuilds.FindByPredicate([Planet](const FPlanetBuildJob& Job) { return Job.Planet == Planet; }))
+	{
+		Queued->RequestId = RequestId;
+		return;
+	}
+
+	FPlanetBuildJob& Job = QueuedBuilds.AddDefaulted_GetRef();
+	Job.Planet = Planet;
+	Job.RequestId = RequestId;
+}
+
+void UPlanetSubsystem::TickGeneration()
+{
+	const UPlanetGeneratorSettings* Settings = GetDefault<UPlanetGeneratorSettings>();
+
+	// Start the most visible queued planets on worker threads. They wait for a calibration in
+	// flight, so they start at the measured presets instead of unclamped.
+	QueuedBuilds.RemoveAll([](const FPlanetBuildJob& Job) { return !Job.Planet.IsValid(); });
+	if (QueuedBuilds.Num() > 0 && RunningBuilds.Num() < Settings->MaxConcurrentBuilds && !UPlanetCalibration::IsCalibrating())
+	{
+		for (FPlanetBuildJob& Job : QueuedBuilds)
+		{
+			Job.Priority = GetGenerationPriority(Job.Planet.Get());
+		}
+		QueuedBuilds.Sort([](const FPlanetBuildJob& A, const FPlanetBuildJob& B) { return A.Priority > B.Priority; });
+
+		const int32 NumToStart = FMath::Min(QueuedBuilds.Num(), Settings->MaxConcurrentBuilds - RunningBuilds.Num());
+		for (int32 i = 0; i < NumToStart; i++)
+		{
+			FPlanetBuildJob& Job = QueuedBuilds[i];
+			const FPlanetBuildSettings BuildSettings = Job.Planet->BeginGeneration();
+			TSharedPtr<FPlanetBuildResult> Target = Job.Planet->TakeBuildResult();
+
+			Job.Result = Async(EAsyncExecution::ThreadPool, [BuildSettings, Target]()
+			{
+				FPlanetMeshBuilder(BuildSettings).Build(*Target);
+				return Target;
+			});
+			RunningBuilds.Add(MoveTemp(Job));
+		}
+		QueuedBuilds.RemoveAt(0, NumToStart);
+	}
+
+	// Apply finished builds, most visible first, until the frame budget is spent. Readiness is
+	// read once per job, so a build finishing mid-tick waits for the next one.
+	TArray<int32> Ready;
+	for (int32 i = 0; i < RunningBuilds.Num(); i++)
+	{
+		FPlanetBuildJob& Job = RunningBuilds[i];
+		if (Job.Result.IsReady())
+		{
+			Job.Priority = GetGenerationPriority(Job.Planet.Get());
+			Ready.Add(i);
+		}
+	}
+	Ready.Sort([this](int32 A, int32 B) { return RunningBuilds[A].Priority > RunningBuilds[B].Priority; });
+
+	const double BudgetSeconds = Settings->GenerationFrameBudgetMs / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+	TArray<int32> Applied;
+	int32 NumApplied = 0;
+	for (int32 Index : Ready)
+	{
+		// Builds for destroyed planets or superseded requests are dropped without applying
+		FPlanetBuildJob& Job = RunningBuilds[Index];
+		APlanetActor* Planet = Job.Planet.Get();
+		if (!Planet || !IsLatestRequest(Job))
+		{
+			Applied.Add(Index);
+			continue;
+		}
+
+		if (NumApplied > 0 && FPlatformTime::Seconds() - StartTime >= BudgetSeconds)
+		{
+			continue;
+		}
+
+		TSharedPtr<FPlanetBuildResult> Result = Job.Result.Get();
+		if (Result.IsValid())
+		{
+			Planet->ApplyBuildResult(MoveTemp(*Result));
+			Planet->RecycleBuildResult(Result);
+			NumApplied++;
+		}
+
+		LatestRequests.Remove(Job.Planet);
+		Applied.Add(Index);
+	}
+
+	// Back to front, so each swap only moves an entry that stays
+	Applied.Sort([](int32 A, int32 B) { return A > B; });
+	for (int32 Index : Applied)
+	{
+		RunningBuilds.RemoveAtSwap(Index);
+	}
+}
+
+float UPlanetSubsystem::GetGenerationPriority(const APlanetActor* Planet) const
+{
+	if (!Planet)
+	{
+		return 0.0f;
+	}
+
+	// Radius over distance is proportional to the planet's size on screen
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (PlayerController && PlayerController->PlayerCameraManager)
+	{
+		const float Distance = FVector::Dist(PlayerController->PlayerCameraManager->GetCameraLocation(), Planet->GetActorLocation());
+		return Planet->PlanetRadius / FMath::Max(Distance - Planet->PlanetRadius, 1.0f);
+	}
+
+	return Planet->PlanetRadius;
+}
+
+bool UPlanetSubsystem::IsLatestRequest(const FPlanetBuildJob& Job) const
+{
+	const uint32* Latest = LatestRequests.Find(Job.Planet);
+	return Job.Planet.IsValid() && Latest && *Latest == Job.RequestId;
+}
+
+void UPlanetSubsystem::UpdateImpostor(APlanetActor* Planet)
+{
+	if (!Planet)
+	{
+		return;
+	}
+
+	if (Planet->HasImpostor())
+	{
+		ImpostorPlanets.AddUnique(Planet);
+	}
+	else
+	{
+		ImpostorPlanets.Remove(Planet);
+		Planet->SetImpostorVisible(false);
+	}
+}
+
+void UPlanetSubsystem::TickImpostors()
+{
+	if (ImpostorPlanets.Num() == 0)
+	{
+		return;
+	}
+
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController || !PlayerController->PlayerCameraManager)
+	{
+		return;
+	}
+
+	const FVector CameraLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+	const float HalfFOVTangent = FMath::Tan(FMath::DegreesToRadians(PlayerController->PlayerCameraManager->GetFOVAngle() * 0.5f));
+
+	for (int32 i = ImpostorPlanets.Num() - 1; i >= 0; i--)
+	{
+		APlanetActor* Planet = ImpostorPlanets[i].Get();
+		if (!Planet)
+		{
+			ImpostorPlanets.RemoveAtSwap(i);
+			continue;
+		}
+
+		// Diameter over the view width at the planet's distance
+		const float Distance = FMath::Max(FVector::Dist(CameraLocation, Planet->GetActorLocation()), 1.0f);
+		const float ScreenSize = Planet->PlanetRadius / (Distance * HalfFOVTangent);
+
+		// A little hysteresis so a planet at the threshold does not flip every frame
+		const float Threshold = Planet->ImpostorScreenSize * (Planet->IsShowingImpostor() ? 1.1f : 1.0f);
+		Planet->SetImpostorVisible(Planet->GovernorForcesImpostor || ScreenSize < Threshold);
+	}
+}
+
+void UPlanetSubsystem::TickMemoryGovernor(float DeltaTime)
+{
+	const UPlanetGeneratorSettings* Settings = GetDefault<UPlanetGeneratorSettings>();
+
+	GovernorElapsed += DeltaTime;
+	if (GovernorElapsed < Settings->MemoryGovernorInterval)
+	{
+		return;
+	}
+	GovernorElapsed = 0.0f;
+
+	struct FGovernedPlanet
+	{
+		APlanetActor* Planet = nullptr;
+		float Importance = 0.0f;
+		int32 Resolution = 0;
+		bool bForceImpostor = false;
+
+		// Measured bytes and the resolution they were measured at; each level holds about 4x the last
+		int64 MeasuredBytes = 0;
+		int32 MeasuredResolution = 0;
+
+		int64 GetBytes() const
+		{
+			const int32 Levels = Resolution - MeasuredResolution;
+			return Levels >= 0 ? MeasuredBytes << (2 * Levels) : MeasuredBytes >> (-2 * Levels);
+		}
+	};
+
+	// Every planet counts towards the budget at the resolution it asks for; only governed ones are lowered
+	TArray<FGovernedPlanet> Governed;
+	TArray<APlanetActor*> Recycling;
+	int64 TotalBytes = 0;
+	int64 RecycledBytes = 0;
+	PlanetGeometryBytes = 0;
+	for (TActorIterator<APlanetActor> It(GetWorld()); It; ++It)
+	{
+		APlanetActor* Planet = *It;
+
+		// Buffers kept for a regeneration that has not come are freed after a while
+		if (Planet->GetRecycledAge() > Settings->RecycledBuildLifetime)
+		{
+			Planet->ReleaseRecycledBuildResult();
+		}
+
+		const int64 Bytes = Planet->GetGeometryMemorySize();
+		const int64 Recycled = Planet->GetRecycledMemorySize();
+		PlanetGeometryBytes += Bytes;
+		if (Recycled > 0)
+		{
+			Recycling.Add(Planet);
+			RecycledBytes += Recycled;
+		}
+
+		// The kept buffers are held at their own size, whatever resolution the planet ends up at
+		FGovernedPlanet Entry;
+		Entry.Planet = Planet;
+		Entry.Resolution = Planet->GetTargetResolution();
+		Entry.MeasuredBytes = Bytes - Recycled;
+		Entry.MeasuredResolution = Planet->LastGenerationStats.Resolution != INDEX_NONE ? Planet->LastGenerationStats.Resolution : Entry.Resolution;
+		TotalBytes += Entry.GetBytes() + Recycled;
+
+		if (Planet->AllowMemoryGovernor)
+		{
+			Entry.Importance = GetGenerationPriority(Planet) * Planet->MemoryImportance;
+			Governed.Add(Entry);
+		}
+	}
+	SET_MEMORY_STAT(STAT_PlanetGeometryMemory, PlanetGeometryBytes);
+
+	// Least important first
+	Governed.Sort([](const FGovernedPlanet& A, const FGovernedPlanet& B) { return A.Importance < B.Importance; });
+
+	const int64 BudgetBytes = (int64)Settings->PlanetMemoryBudgetMB * 1024 * 1024;
+	if (BudgetBytes > 0)
+	{
+		// Kept buffers only save allocations, so they go before any planet loses detail
+		if (TotalBytes > BudgetBytes)
+		{
+			for (APlanetActor* Planet : Recycling)
+			{
+				Planet->ReleaseRecycledBuildResult();
+			}
+			TotalBytes -= RecycledBytes;
+		}
+
+		// Lower the least important planet one level at a time down to the minimum
+		for (FGovernedPlanet& Entry : Governed)
+		{
+			while (TotalBytes > BudgetBytes && Entry.Resolution > Settings->MinGovernedResolution)
+			{
+				const int64 Before = Entry.GetBytes();
+				Entry.Resolution--;
+				TotalBytes -= Before - Entry.GetBytes();
+			}
+		}
+
+		// Still over: planets with an impostor drop to the coarsest mesh and show the impostor instead
+		for (FGovernedPlanet& Entry : Governed)
+		{
+			if (TotalBytes <= BudgetBytes)
+			{
+				break;
+			}
+			if (Entry.Planet->HasImpostor() && Entry.Resolution > 0)
+			{
+				const int64 Before = Entry.GetBytes();
+				Entry.Resolution = 0;
+				Entry.bForceImpostor = true;
+				TotalBytes -= Before - Entry.GetBytes();
+			}
+		}
+	}
+
+	bool bChanged = false;
+	for (const FGovernedPlanet& Entry : Governed)
+	{
+		APlanetActor* Planet = Entry.Planet;
+		const int32 Cap = Entry.Resolution < Planet->GetTargetResolution() ? Entry.Resolution : INDEX_NONE;
+		if (Cap == Planet->GovernedResolution && Entry.bForceImpostor == Planet->GovernorForcesImpostor)
+		{
+			continue;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("PlanetMemoryGovernor: %s resolution %d -> %d%s, about %.1f MB"),
+			*Planet->GetName(), Planet->GetEffectiveResolution(), Cap == INDEX_NONE ? Planet->GetTargetResolution() : Cap,
+			Entry.bForceImpostor ? TEXT(" on its impostor") : TEXT(""), Entry.GetBytes() / (1024.0 * 1024.0));
+
+		Planet->SetMemoryGovernorState(Cap, Entry.bForceImpostor);
+		bChanged = true;
+	}
+
+	if (bChanged)
+	{
+		UE_LOG(LogTemp, Display, TEXT("PlanetMemoryGovernor: Planets hold %.1f MB, about %.1f MB once rebuilt, budget %d MB"),
+			PlanetGeometryBytes / (1024.0 * 1024.0), TotalBytes / (1024.0 * 1024.0), Settings->PlanetMemoryBudgetMB);
+		if (BudgetBytes > 0 && TotalBytes > BudgetBytes)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("PlanetMemoryGovernor: Planets exceed the budget at their lowest governed resolution"));
+		}
+	}
+}
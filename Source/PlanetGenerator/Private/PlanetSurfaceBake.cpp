@@ -0,0 +1,93 @@
+#include "PlanetSurfaceBake.h"
+#include "PlanetSpatialIndex.h"
+#include "Async/ParallelFor.h"
+
+void FPlanetSurfaceBake::Reset()
+{
+	FaceResolution = 0;
+	Heights.Reset();
+	Albedo.Reset();
+	Normals.Reset();
+}
+
+void FPlanetSurfaceBaker::Bake(int32 FaceResolution, float HeightScale,
+	TFunctionRef<float(const FVector&)> ElevationAt,
+	TFunctionRef<FLinearColor(const FVector&, float)> AlbedoAt,
+	FPlanetSurfaceBake& OutBake)
+{
+	OutBake.Reset();
+	if (FaceResolution <= 0)
+	{
+		return;
+	}
+
+	const int32 N = FaceResolution;
+	OutBake.FaceResolution = N;
+	OutBake.Heights.SetNumUninitialized(OutBake.GetWidth() * OutBake.GetHeight());
+	OutBake.Albedo.SetNumUninitialized(OutBake.Heights.Num());
+	OutBake.Normals.SetNumUninitialized(OutBake.Heights.Num());
+
+	// Heights go into per-face grids with a one texel border, so normals can use central
+	// differences right up to the face edges without evaluating the noise again
+	const int32 Border = N + 2;
+	TArray<float> BorderHeights;
+	BorderHeights.SetNumUninitialized(6 * Border * Border);
+
+	auto BorderDirection = [N](int32 Face, int32 X, int32 Y)
+	{
+		return FPlanetSpatialIndex::CubeFaceToDirection(Face, (X - 0.5f) / N, (Y - 0.5f) / N);
+	};
+
+	ParallelFor(6 * Border, [&](int32 Row)
+	{
+		const int32 Face = Row / Border;
+		const int32 Y = Row % Border;
+		float* Heights = &BorderHeights[(Face * Border + Y) * Border];
+		for (int32 X = 0; X < Border; X++)
+		{
+			Heights[X] = ElevationAt(BorderDirection(Face, X, Y));
+		}
+	});
+
+	// Normals and albedo are written in square tiles to keep each task's reads local
+	const int32 TileSize = 32;
+	const int32 TilesPerEdge = FMath::DivideAndRoundUp(N, TileSize);
+
+	ParallelFor(6 * TilesPerEdge * TilesPerEdge, [&](int32 TaskIndex)
+	{
+		const int32 Face = TaskIndex / (TilesPerEdge * TilesPerEdge);
+		const int32 TileX = (TaskIndex / TilesPerEdge) % TilesPerEdge;
+		const int32 TileY = TaskIndex % TilesPerEdge;
+		const float* FaceHeights = &BorderHeights[Face * Border * Border];
+
+		auto SurfacePoint = [&](int32 X, int32 Y)
+		{
+			return BorderDirection(Face, X, Y) * (1.0f + FaceHeights[Y * Border + X] * HeightScale);
+		};
+
+		for (int32 Y = TileY * TileSize; Y < FMath::Min((TileY + 1) * TileSize, N); Y++)
+		{
+			for (int32 X = TileX * TileSize; X < FMath::Min((TileX + 1) * TileSize, N); X++)
+			{
+				// Texel (X, Y) sits at (X + 1, Y + 1) in the bordered grid
+				const int32 BX = X + 1;
+				const int32 BY = Y + 1;
+				const float Elevation = FaceHeights[BY * Border + BX];
+				const FVector Direction = BorderDirection(Face, BX, BY);
+
+				const FVector DU = SurfacePoint(BX + 1, BY) - SurfacePoint(BX - 1, BY);
+				const FVector DV = SurfacePoint(BX, BY + 1) - SurfacePoint(BX, BY - 1);
+				FVector Normal = FVector::CrossProduct(DU, DV).GetSafeNormal();
+				if (FVector::DotProduct(Normal, Direction) < 0.0f)
+				{
+					Normal = -Normal;
+				}
+
+				const int32 Texel = Y * OutBake.GetWidth() + Face * N + X;
+				OutBake.Heights[Texel] = Elevation;
+				OutBake.Albedo[Texel] = AlbedoAt(Direction, Elevation).ToFColor(true);
+				OutBake.Normals[Texel] = FLinearColor(Normal * 0.5f + FVector(0.5f)).ToFColor(false);
+			}
+		}
+	});
+}
@@ -0,0 +1,163 @@
+#include "PlanetSurfaceSampler.h"
+#include "Async/ParallelFor.h"
+
+FPlanetSurfaceSampler::FPlanetSurfaceSampler(const TArray<FVector>& InPositions, const TArray<int32>& InTriangles, TSharedPtr<const FPlanetTileGraph> InTileGraph, TSharedPtr<const FPlanetSpatialIndex> InSpatialIndex, TSharedPtr<const FPlanetTileAttributes> InAttributes)
+{
+	Build(InPositions, InTriangles, InTileGraph, InSpatialIndex, InAttributes);
+}
+
+void FPlanetSurfaceSampler::Build(const TArray<FVector>& InPositions, const TArray<int32>& InTriangles, TSharedPtr<const FPlanetTileGraph> InTileGraph, TSharedPtr<const FPlanetSpatialIndex> InSpatialIndex, TSharedPtr<const FPlanetTileAttributes> InAttributes)
+{
+	Positions = InPositions;
+	Triangles = InTriangles;
+	TileGraph = InTileGraph;
+	SpatialIndex = InSpatialIndex;
+	Attributes = InAttributes;
+}
+
+void FPlanetSurfaceSampler::Reset()
+{
+	Positions.Reset();
+	Triangles.Reset();
+	TileGraph.Reset();
+	SpatialIndex.Reset();
+	Attributes.Reset();
+}
+
+bool FPlanetSurfaceSampler::IntersectTile(int32 Tile, const FVector& Direction, FVector& OutBarycentric, float& OutDistance) const
+{
+	const FVector& A = Positions[Triangles[Tile * 3]];
+	const FVector& B = Positions[Triangles[Tile * 3 + 1]];
+	const FVector& C = Positions[Triangles[Tile * 3 + 2]];
+
+	// Moller-Trumbore with the ray starting at the planet centre
+	const FVector EdgeAB = B - A;
+	const FVector EdgeAC = C - A;
+	const FVector P = FVector::CrossProduct(Direction, EdgeAC);
+	const float Det = FVector::DotProduct(EdgeAB, P);
+	if (FMath::Abs(Det) < SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	const float InvDet = 1.0f / Det;
+	const FVector T = -A;
+	const float U = FVector::DotProduct(T, P) * InvDet;
+	const FVector Q = FVector::CrossProduct(T, EdgeAB);
+	const float V = FVector::DotProduct(Direction, Q) * InvDet;
+
+	OutBarycentric = FVector(1.0f - U - V, U, V);
+	OutDistance = FVector::DotProduct(EdgeAC, Q) * InvDet;
+
+	const float Tolerance = -KINDA_SMALL_NUMBER;
+	return U >= Tolerance && V >= Tolerance && U + V <= 1.0f - Tolerance && OutDistance > 0.0f;
+}
+
+FPlanetSurfaceSample FPlanetSurfaceSampler::Sample(const FVector& Direction) const
+{
+	FPlanetSurfaceSample Result;
+	if (!IsValid())
+	{
+		return Result;
+	}
+
+	const FVector Ray = Direction.GetSafeNormal();
+	const int32 NearestTile = SpatialIndex->FindNearestTile(Ray);
+
+	// The nearest tile centre is almost always the hit; otherwise the hit is one or two steps away
+	FVector Barycentric;
+	float Distance = 0.0f;
+	int32 HitTile = INDEX_NONE;
+
+	if (IntersectTile(NearestTile, Ray, Barycentric, Distance))
+	{
+		HitTile = NearestTile;
+	}
+	else
+	{
+		for (int32 Neighbour : TileGraph->GetTileNeighbours(NearestTile))
+		{
+			if (IntersectTile(Neighbour, Ray, Barycentric, Distance))
+			{
+				HitTile = Neighbour;
+				break;
+			}
+
+			for (int32 Second : TileGraph->GetTileNeighbours(Neighbour))
+			{
+				if (IntersectTile(Second, Ray, Barycentric, Distance))
+				{
+					HitTile = Second;
+					break;
+				}
+			}
+
+			if (HitTile != INDEX_NONE)
+			{
+				break;
+			}
+		}
+	}
+
+	// Fall back to the nearest tile with clamped weights, which only happens on degenerate input
+	if (HitTile == INDEX_NONE)
+	{
+		HitTile = NearestTile;
+		IntersectTile(HitTile, Ray, Barycentric, Distance);
+		Barycentric = FVector(FMath::Max(Barycentric.X, 0.0f), FMath::Max(Barycentric.Y, 0.0f), FMath::Max(Barycentric.Z, 0.0f));
+		Barycentric /= FMath::Max(Barycentric.X + Barycentric.Y + Barycentric.Z, SMALL_NUMBER);
+	}
+
+	const int32 Index1 = Triangles[HitTile * 3];
+	const int32 Index2 = Triangles[HitTile * 3 + 1];
+	const int32 Index3 = Triangles[HitTile * 3 + 2];
+	const FVector& A = Positions[Index1];
+	const FVector& B = Positions[Index2];
+	const FVector& C = Positions[Index3];
+
+	Result.TileIndex = HitTile;
+	Result.Position = A * Barycentric.X + B * Barycentric.Y + C * Barycentric.Z;
+
+	// Face normal of the terrain, flipped outward regardless of winding
+	Result.Normal = FVector::CrossProduct(B - A, C - A).GetSafeNormal();
+	if (FVector::DotProduct(Result.Normal, Ray) < 0.0f)
+	{
+		Result.Normal = -Result.Normal;
+	}
+
+	// Biome of the dominant corner, which matches the vertex colour blend of the rendered mesh
+	if (Attributes.IsValid() && Attributes->GetNumVertices() == Positions.Num())
+	{
+		int32 Dominant = Index1;
+		if (Barycentric.Y > Barycentric.X && Barycentric.Y >= Barycentric.Z)
+		{
+			Dominant = Index2;
+		}
+		else if (Barycentric.Z > Barycentric.X && Barycentric.Z > Barycentric.Y)
+		{
+			Dominant = Index3;
+		}
+		Result.Biome = Attributes->VertexBiomes[Dominant];
+	}
+
+	return Result;
+}
+
+void FPlanetSurfaceSampler::SampleBatch(TArrayView<const FVector> Directions, TArrayView<FPlanetSurfaceSample> OutSamples) const
+{
+	check(Directions.Num() == OutSamples.Num());
+
+	// Small batches are not worth waking the task graph for
+	const int32 BatchSize = 256;
+	const int32 NumBatches = FMath::DivideAndRoundUp(Directions.Num(), BatchSize);
+
+	ParallelFor(NumBatches, [&](int32 Batch)
+	{
+		const int32 Start = Batch * BatchSize;
+		const int32 End = FMath::Min(Start + BatchSize, Directions.Num());
+		for (int32 i = Start; i < End; i++)
+		{
+			OutSamples[i] = Sample(Directions[i]);
+		}
+	}, NumBatches == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
@@ -0,0 +1,53 @@
+#include "PlanetTileAttributes.h"
+
+void FPlanetTileAttributes::SetNumVertices(int32 NumVertices)
+{
+	VertexHeights.SetNumUninitialized(NumVertices);
+	VertexTemperatures.SetNumUninitialized(NumVertices);
+	VertexMoistures.SetNumUninitialized(NumVertices);
+	VertexBiomes.SetNumUninitialized(NumVertices);
+}
+
+void FPlanetTileAttributes::BuildTiles(const TArray<int32>& Triangles, TFunctionRef<uint8(float, float, float)> Classify)
+{
+	const int32 NumTiles = Triangles.Num() / 3;
+	TileHeights.SetNumUninitialized(NumTiles);
+	TileTemperatures.SetNumUninitialized(NumTiles);
+	TileMoistures.SetNumUninitialized(NumTiles);
+	TileBiomes.SetNumUninitialized(NumTiles);
+
+	for (int32 i = 0; i < NumTiles; i++)
+	{
+		int32 Index1 = Triangles[i * 3];
+		int32 Index2 = Triangles[i * 3 + 1];
+		int32 Index3 = Triangles[i * 3 + 2];
+
+		float Height = (VertexHeights[Index1] + VertexHeights[Index2] + VertexHeights[Index3]) / 3.0f;
+		float Temperature = (VertexTemperatures[Index1] + VertexTemperatures[Index2] + VertexTemperatures[Index3]) / 3.0f;
+		float Moisture = (VertexMoistures[Index1] + VertexMoistures[Index2] + VertexMoistures[Index3]) / 3.0f;
+
+		TileHeights[i] = Height;
+		TileTemperatures[i] = Temperature;
+		TileMoistures[i] = Moisture;
+		TileBiomes[i] = Classify(Height, Temperature, Moisture);
+	}
+}
+
+void FPlanetTileAttributes::Reset()
+{
+	VertexHeights.Reset();
+	VertexTemperatures.Reset();
+	VertexMoistures.Reset();
+	VertexBiomes.Reset();
+
+	TileHeights.Reset();
+	TileTemperatures.Reset();
+	TileMoistures.Reset();
+	TileBiomes.Reset();
+}
+
+SIZE_T FPlanetTileAttributes::GetAllocatedSize() const
+{
+	return VertexHeights.GetAllocatedSize() + VertexTemperatures.GetAllocatedSize() + VertexMoistures.GetAllocatedSize() + VertexBiomes.GetAllocatedSize()
+		+ TileHeights.GetAllocatedSize() + TileTemperatures.GetAllocatedSize() + TileMoistures.GetAllocatedSize() + TileBiomes.GetAllocatedSize();
+}
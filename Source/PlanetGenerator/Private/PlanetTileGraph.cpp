@@ -0,0 +1,177 @@
+#include "PlanetTileGraph.h"
+
+void FPlanetTileGraph::Build(const TArray<FVector>& UnitVertices, const TArray<int32>& Triangles, const TArray<int32>& TriangleNeighbours)
+{
+	Reset();
+
+	const int32 NumTiles = Triangles.Num() / 3;
+	const int32 NumVertices = UnitVertices.Num();
+
+	if (NumTiles == 0 || TriangleNeighbours.Num() != Triangles.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPlanetTileGraph::Build: Missing triangle neighbours, graph not built"));
+		return;
+	}
+
+	// Every tile of a closed triangle mesh has exactly three edge neighbours
+	TileOffsets.SetNumUninitialized(NumTiles + 1);
+	for (int32 i = 0; i <= NumTiles; i++)
+	{
+		TileOffsets[i] = i * 3;
+	}
+	TileNeighbours = TriangleNeighbours;
+
+	TileCenters.SetNumUninitialized(NumTiles);
+	for (int32 i = 0; i < NumTiles; i++)
+	{
+		const FVector& V1 = UnitVertices[Triangles[i * 3]];
+		const FVector& V2 = UnitVertices[Triangles[i * 3 + 1]];
+		const FVector& V3 = UnitVertices[Triangles[i * 3 + 2]];
+		TileCenters[i] = (V1 + V2 + V3).GetSafeNormal();
+	}
+
+	// Each undirected edge is visited once, from the triangle with the lower index
+	VertexOffsets.SetNumZeroed(NumVertices + 1);
+	for (int32 i = 0; i < NumTiles; i++)
+	{
+		for (int32 k = 0; k < 3; k++)
+		{
+			if (i < TriangleNeighbours[i * 3 + k])
+			{
+				VertexOffsets[Triangles[i * 3 + k] + 1]++;
+				VertexOffsets[Triangles[i * 3 + (k + 1) % 3] + 1]++;
+			}
+		}
+	}
+
+	for (int32 i = 0; i < NumVertices; i++)
+	{
+		VertexOffsets[i + 1] += VertexOffsets[i];
+	}
+
+	TArray<int32> Cursor;
+	Cursor.SetNumUninitialized(NumVertices);
+	FMemory::Memcpy(Cursor.GetData(), VertexOffsets.GetData(), NumVertices * sizeof(int32));
+
+	VertexNeighbours.SetNumUninitialized(VertexOffsets[NumVertices]);
+	for (int32 i = 0; i < NumTiles; i++)
+	{
+		for (int32 k = 0; k < 3; k++)
+		{
+			if (i < TriangleNeighbours[i * 3 + k])
+			{
+				int32 A = Triangles[i * 3 + k];
+				int32 B = Triangles[i * 3 + (k + 1) % 3];
+				VertexNeighbours[Cursor[A]++] = B;
+				VertexNeighbours[Cursor[B]++] = A;
+			}
+		}
+	}
+}
+
+void FPlanetTileGraph::Reset()
+{
+	TileOffsets.Reset();
+	TileNeighbours.Reset();
+	VertexOffsets.Reset();
+	VertexNeighbours.Reset();
+	TileCenters.Reset();
+}
+
+SIZE_T FPlanetTileGraph::GetAllocatedSize() const
+{
+	return TileOffsets.GetAllocatedSize() + TileNeighbours.GetAllocatedSize() + VertexOffsets.GetAllocatedSize()
+		+ VertexNeighbours.GetAllocatedSize() + TileCenters.GetAllocatedSize();
+}
+
+TArrayView<const int32> FPlanetTileGraph::GetTileNeighbours(int32 TileIndex) const
+{
+	if (!IsValidTile(TileIndex))
+	{
+		return TArrayView<const int32>();
+	}
+
+	return TArrayView<const int32>(TileNeighbours.GetData() + TileOffsets[TileIndex], TileOffsets[TileIndex + 1] - TileOffsets[TileIndex]);
+}
+
+TArrayView<const int32> FPlanetTileGraph::GetVertexNeighbours(int32 VertexIndex) const
+{
+	if (!IsValidVertex(VertexIndex))
+	{
+		return TArrayView<const int32>();
+	}
+
+	return TArrayView<const int32>(VertexNeighbours.GetData() + VertexOffsets[VertexIndex], VertexOffsets[VertexIndex + 1] - VertexOffsets[VertexIndex]);
+}
+
+void FPlanetTileGraph::GetTileRing(int32 TileIndex, int32 Distance, TArray<int32>& OutTiles) const
+{
+	OutTiles.Reset();
+
+	if (!IsValidTile(TileIndex) || Distance < 0)
+	{
+		return;
+	}
+
+	TBitArray<> Visited(false, GetNumTiles());
+	Visited[TileIndex] = true;
+	OutTiles.Add(TileIndex);
+
+	// Expand one breadth-first layer at a time, keeping only the last one
+	TArray<int32> NextLayer;
+	for (int32 Step = 0; Step < Distance && OutTiles.Num() > 0; Step++)
+	{
+		NextLayer.Reset();
+		for (int32 Tile : OutTiles)
+		{
+			for (int32 Neighbour : GetTileNeighbours(Tile))
+			{
+				if (!Visited[Neighbour])
+				{
+					Visited[Neighbour] = true;
+					NextLayer.Add(Neighbour);
+				}
+			}
+		}
+
+		Swap(OutTiles, NextLayer);
+	}
+}
+
+int32 FPlanetTileGraph::LabelComponents(TFunctionRef<bool(int32, int32)> SameRegion, TArray<int32>& OutLabels) const
+{
+	const int32 NumTiles = GetNumTiles();
+	OutLabels.Init(INDEX_NONE, NumTiles);
+
+	TArray<int32> Queue;
+	Queue.Reserve(NumTiles);
+
+	int32 NumComponents = 0;
+	for (int32 Seed = 0; Seed < NumTiles; Seed++)
+	{
+		if (OutLabels[Seed] != INDEX_NONE)
+		{
+			continue;
+		}
+
+		const int32 Label = NumComponents++;
+		OutLabels[Seed] = Label;
+
+		Queue.Reset();
+		Queue.Add(Seed);
+		for (int32 Head = 0; Head < Queue.Num(); Head++)
+		{
+			const int32 Tile = Queue[Head];
+			for (int32 Neighbour : GetTileNeighbours(Tile))
+			{
+				if (OutLabels[Neighbour] == INDEX_NONE && SameRegion(Tile, Neighbour))
+				{
+					OutLabels[Neighbour] = Label;
+					Queue.Add(Neighbour);
+				}
+			}
+		}
+	}
+
+	return NumComponents;
+}
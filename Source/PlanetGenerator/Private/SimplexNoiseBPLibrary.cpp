@@ -1,38 +1,58 @@
 #include "SimplexNoiseBPLibrary.h"
+#include "Misc/ScopeLock.h"
+#include <atomic>
 
 // Simplex Noise implementation based on the public domain code by Stefan Gustavson
 
-// Permutation table
-static int32 Perm[512];
-static bool bIsInitialized = false;
-
-// Initialize the permutation table with a given seed
-static void InitializePermTable(int32 Seed)
+// Permutation table of one seed. Tables never change once built: a reseed publishes a new one, so
+// a noise call on any thread reads one consistent table.
+struct FSimplexPermTable
 {
-	FMath::RandInit(Seed);
+	int32 Perm[512];
 
-	// Fill the permutation table
-	for (int32 i = 0; i < 256; i++)
+	// FRandomStream gives the same table on every platform and compiler, unlike the global
+	// FMath::Rand state
+	explicit FSimplexPermTable(int32 Seed)
 	{
-		Perm[i] = i;
+		FRandomStream Stream(Seed);
+
+		// Fill the permutation table
+		for (int32 i = 0; i < 256; i++)
+		{
+			Perm[i] = i;
+		}
+
+		// Shuffle the permutation table
+		for (int32 i = 255; i > 0; i--)
+		{
+			int32 j = Stream.RandRange(0, i);
+			int32 Temp = Perm[i];
+			Perm[i] = Perm[j];
+			Perm[j] = Temp;
+		}
+
+		// Duplicate the permutation table
+		for (int32 i = 0; i < 256; i++)
+		{
+			Perm[i + 256] = Perm[i];
+		}
 	}
+};
 
-	// Shuffle the permutation table
-	for (int32 i = 255; i > 0; i--)
-	{
-		int32 j = FMath::RandRange(0, i);
-		int32 Temp = Perm[i];
-		Perm[i] = Perm[j];
-		Perm[j] = Temp;
-	}
+// Built on first use; the compiler guards the initialisation, so racing first calls are safe
+static const FSimplexPermTable& GetDefaultPermTable()
+{
+	static const FSimplexPermTable Table(USimplexNoiseBPLibrary::DefaultSeed);
+	return Table;
+}
 
-	// Duplicate the permutation table
-	for (int32 i = 0; i < 256; i++)
-	{
-		Perm[i + 256] = Perm[i];
-	}
+// Table the Blueprint noise functions read; null until SetNoiseSeed picks another seed
+static std::atomic<const FSimplexPermTable*> SeededPermTable{ nullptr };
 
-	bIsInitialized = true;
+static FORCEINLINE const int32* GetPermTable()
+{
+	const FSimplexPermTable* Table = SeededPermTable.load(std::memory_order_acquire);
+	return Table ? Table->Perm : GetDefaultPermTable().Perm;
 }
 
 // Helper functions
@@ -70,13 +90,8 @@ static float Grad(int32 Hash, float X, float Y, float Z, float W)
 }
 
 // 1D Simplex Noise
-float USimplexNoiseBPLibrary::SimplexNoise1D(float X)
+static FORCEINLINE float SimplexNoise1DKernel(const int32* RESTRICT Perm, float X)
 {
-	if (!bIsInitialized)
-	{
-		InitializePermTable(1337);
-	}
-
 	int32 i0 = FMath::FloorToInt(X);
 	int32 i1 = i0 + 1;
 	float x0 = X - i0;
@@ -98,13 +113,8 @@ float USimplexNoiseBPLibrary::SimplexNoise1D(float X)
 }
 
 // 2D Simplex Noise
-float USimplexNoiseBPLibrary::SimplexNoise2D(float X, float Y)
+static FORCEINLINE float SimplexNoise2DKernel(const int32* RESTRICT Perm, float X, float Y)
 {
-	if (!bIsInitialized)
-	{
-		InitializePermTable(1337);
-	}
-
 	// Skew the input space to determine which simplex cell we're in
 	const float F2 = 0.366025403f; // F2 = (sqrt(3) - 1) / 2
 	const float G2 = 0.211324865f; // G2 = (3 - sqrt(3)) / 6
@@ -170,13 +180,8 @@ float USimplexNoiseBPLibrary::SimplexNoise2D(float X, float Y)
 }
 
 // 3D Simplex Noise
-float USimplexNoiseBPLibrary::SimplexNoise3D(float X, float Y, float Z)
+static FORCEINLINE float SimplexNoise3DKernel(const int32* RESTRICT Perm, float X, float Y, float Z)
 {
-	if (!bIsInitialized)
-	{
-		InitializePermTable(1337);
-	}
-
 	// Skew the input space to determine which simplex cell we're in
 	const float F3 = 1.0f / 3.0f;
 	const float G3 = 1.0f / 6.0f; // Very nice and simple skew factor for 3D
@@ -265,13 +270,8 @@ float USimplexNoiseBPLibrary::SimplexNoise3D(float X, float Y, float Z)
 }
 
 // 4D Simplex Noise
-float USimplexNoiseBPLibrary::SimplexNoise4D(float X, float Y, float Z, float W)
+static FORCEINLINE float SimplexNoise4DKernel(const int32* RESTRICT Perm, float X, float Y, float Z, float W)
 {
-	if (!bIsInitialized)
-	{
-		InitializePermTable(1337);
-	}
-
 	// The skewing and unskewing factors are hairy again for the 4D case
 	const float F4 = (FMath::Sqrt(5.0f) - 1.0f) / 4.0f;
 	const float G4 = (5.0f - FMath::Sqrt(5.0f)) / 20.0f;
@@ -410,6 +410,75 @@ float USimplexNoiseBPLibrary::SimplexNoise4D(float X, float Y, float Z, float W)
 	return 27.0f * (n0 + n1 + n2 + n3 + n4);
 }
 
+float USimplexNoiseBPLibrary::SimplexNoise1D(float X)
+{
+	return SimplexNoise1DKernel(GetPermTable(), X);
+}
+
+float USimplexNoiseBPLibrary::SimplexNoise2D(float X, float Y)
+{
+	return SimplexNoise2DKernel(GetPermTable(), X, Y);
+}
+
+float USimplexNoiseBPLibrary::SimplexNoise3D(float X, float Y, float Z)
+{
+	return SimplexNoise3DKernel(GetPermTable(), X, Y, Z);
+}
+
+float USimplexNoiseBPLibrary::SimplexNoise3DDefaultSeed(float X, float Y, float Z)
+{
+	return SimplexNoise3DKernel(GetDefaultPermTable().Perm, X, Y, Z);
+}
+
+float USimplexNoiseBPLibrary::SimplexNoise4D(float X, float Y, float Z, float W)
+{
+	return SimplexNoise4DKernel(GetPermTable(), X, Y, Z, W);
+}
+
+void USimplexNoiseBPLibrary::SimplexNoise3DBatch(TArrayView<const FVector> Points, TArrayView<float> OutValues)
+{
+	check(Points.Num() == OutValues.Num());
+
+	// One table lookup for the whole batch; the kernel inlines into the loop
+	const int32* Perm = GetPermTable();
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		const FVector& Point = Points[i];
+		OutValues[i] = SimplexNoise3DKernel(Perm, Point.X, Point.Y, Point.Z);
+	}
+}
+
+void USimplexNoiseBPLibrary::SimplexNoiseFBMBatch(TArrayView<const FVector> Points, int32 Octaves, float Persistence, float Lacunarity, TArrayView<float> OutValues)
+{
+	check(Points.Num() == OutValues.Num());
+
+	const int32* Perm = GetPermTable();
+
+	float MaxValue = 0.0f;
+	float Amplitude = 1.0f;
+	for (int32 Octave = 0; Octave < Octaves; Octave++)
+	{
+		MaxValue += Amplitude;
+		Amplitude *= Persistence;
+	}
+
+	// Same accumulation order as SimplexNoiseFBM, so results match it exactly
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		const FVector& Point = Points[i];
+		float Total = 0.0f;
+		float Frequency = 1.0f;
+		Amplitude = 1.0f;
+		for (int32 Octave = 0; Octave < Octaves; Octave++)
+		{
+			Total += SimplexNoise3DKernel(Perm, Point.X * Frequency, Point.Y * Frequency, Point.Z * Frequency) * Amplitude;
+			Amplitude *= Persistence;
+			Frequency *= Lacunarity;
+		}
+		OutValues[i] = Total / MaxValue;
+	}
+}
+
 // Fractal Brownian Motion (FBM) noise
 float USimplexNoiseBPLibrary::SimplexNoiseFBM(float X, float Y, float Z, int32 Octaves, float Persistence, float Lacunarity)
 {
@@ -432,5 +501,16 @@ float USimplexNoiseBPLibrary::SimplexNoiseFBM(float X, float Y, float Z, int32 O
 // Set the seed for the noise
 void USimplexNoiseBPLibrary::SetNoiseSeed(int32 NewSeed)
 {
-	InitializePermTable(NewSeed);
+	// Tables are kept for the life of the process, since a call on another thread may still be
+	// reading the one being replaced. They are 2 KiB each and a game uses a handful of seeds.
+	static FCriticalSection TablesLock;
+	static TMap<int32, TUniquePtr<FSimplexPermTable>> Tables;
+
+	FScopeLock Lock(&TablesLock);
+	TUniquePtr<FSimplexPermTable>& Table = Tables.FindOrAdd(NewSeed);
+	if (!Table.IsValid())
+	{
+		Table = MakeUnique<FSimplexPermTable>(NewSeed);
+	}
+	SeededPermTable.store(Table.Get(), std::memory_order_release);
 }
@@ -0,0 +1,105 @@
+#include "Misc/AutomationTest.h"
+#include "PlanetActor.h"
+#include "PlanetMeshBuilder.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+struct FPlanetGoldenHash
+{
+	int32 Seed;
+	int32 Resolution;
+	const TCHAR* Hash;
+};
+
+// Output hashes of the default planet settings, taken from the test's log on a reference machine.
+// Only update them for an intended change to the generated surface. A case without an entry is
+// still checked across worker counts, and logs the entry to add.
+static const TArray<FPlanetGoldenHash> GoldenHashes =
+{
+};
+
+static const TCHAR* FindGoldenHash(int32 Seed, int32 Resolution)
+{
+	for (const FPlanetGoldenHash& Golden : GoldenHashes)
+	{
+		if (Golden.Seed == Seed && Golden.Resolution == Resolution)
+		{
+			return Golden.Hash;
+		}
+	}
+	return nullptr;
+}
+
+// A seed and parameter set must always produce the same planet. Each case is built on the calling
+// thread, then on 4 and on all task graph workers, then as 4 concurrent builds, and every output
+// hash must match the first one and the golden table.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetDeterminismTest, "PlanetGenerator.Determinism",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetDeterminismTest::RunTest(const FString& Parameters)
+{
+	const int32 Seeds[] = { 1337, 42 };
+	const int32 MaxResolution = 5;
+	const int32 NumWorkers = FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+	const int32 WorkerCounts[] = { 4, NumWorkers };
+	const int32 Concurrency = 4;
+
+	AddInfo(FString::Printf(TEXT("%d task graph workers"), NumWorkers));
+
+	const FPlanetBuildSettings BaseSettings = GetDefault<APlanetActor>()->MakeBuildSettings();
+
+	for (int32 Seed : Seeds)
+	{
+		for (int32 Resolution = 0; Resolution <= MaxResolution; Resolution++)
+		{
+			FPlanetBuildSettings Settings = BaseSettings;
+			Settings.Seed = Seed;
+			Settings.Resolution = Resolution;
+			Settings.bComputeOutputHash = true;
+			Settings.MaxWorkers = 1;
+
+			FPlanetBuildResult Reference;
+			FPlanetMeshBuilder(Settings).Build(Reference);
+
+			for (int32 Workers : WorkerCounts)
+			{
+				Settings.MaxWorkers = Workers;
+
+				FPlanetBuildResult Result;
+				FPlanetMeshBuilder(Settings).Build(Result);
+				TestEqual(FString::Printf(TEXT("Seed %d, resolution %d on %d workers"), Seed, Resolution, Workers), Result.OutputHash, Reference.OutputHash);
+			}
+
+			Settings.MaxWorkers = 0;
+			TArray<FString> Hashes;
+			Hashes.SetNum(Concurrency);
+			ParallelFor(Concurrency, [&Settings, &Hashes](int32 Index)
+			{
+				FPlanetBuildResult Result;
+				FPlanetMeshBuilder(Settings).Build(Result);
+				Hashes[Index] = MoveTemp(Result.OutputHash);
+			});
+
+			for (const FString& Hash : Hashes)
+			{
+				TestEqual(FString::Printf(TEXT("Seed %d, resolution %d in %d concurrent builds"), Seed, Resolution, Concurrency), Hash, Reference.OutputHash);
+			}
+
+			if (const TCHAR* Golden = FindGoldenHash(Seed, Resolution))
+			{
+				TestEqual(FString::Printf(TEXT("Seed %d, resolution %d against its golden hash"), Seed, Resolution), Reference.OutputHash, FString(Golden));
+			}
+			else
+			{
+				AddWarning(FString::Printf(TEXT("Seed %d, resolution %d has no golden hash; add { %d, %d, TEXT(\"%s\") }"),
+					Seed, Resolution, Seed, Resolution, *Reference.OutputHash));
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,205 @@
+#include "Misc/AutomationTest.h"
+#include "SimplexNoiseBPLibrary.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Seed the golden table was recorded with; also the library's default
+static constexpr int32 GoldenSeed = USimplexNoiseBPLibrary::DefaultSeed;
+
+// Sample points and the expected 1D, 2D, 3D and 4D values at them for GoldenSeed. The 1D value
+// uses X, 2D uses X and Y, and so on. Re-record these only for an intended change to the noise.
+static const float GoldenPoints[][4] =
+{
+	{ 0.1f, 0.2f, 0.3f, 0.4f },
+	{ 1.5f, -2.25f, 3.75f, 0.5f },
+	{ -7.3f, 4.1f, -0.6f, 2.2f },
+	{ 12.34f, 56.78f, -9.1f, -3.3f },
+	{ 0.0f, 0.0f, 0.0f, 0.0f },
+	{ 100.5f, -200.25f, 50.125f, 7.0f },
+	{ -0.9f, -0.9f, -0.9f, -0.9f },
+	{ 3.14159f, 2.71828f, 1.41421f, 1.73205f },
+};
+
+static const float GoldenValues[][4] =
+{
+	{ -0.0740339309f, -0.0147441691f, 0.203192472f, -0.139407605f },
+	{ -0.187470704f, 0.522324085f, -0.658252716f, -0.32555148f },
+	{ 0.606241107f, -0.756887436f, 0.264165372f, 0.249114603f },
+	{ 0.41361025f, 0.272681504f, 0.183550656f, -0.132807329f },
+	{ 0.0f, 0.0f, 0.0f, 0.0f },
+	{ 0.062490236f, 0.586361408f, -0.0891873538f, 0.00291536213f },
+	{ 0.114757247f, 0.480840236f, 0.00530843483f, 0.0194843952f },
+	{ -0.401231349f, 0.723612428f, -0.385231286f, -0.0788996667f },
+};
+
+// Room for compilers that fuse or reorder the float math differently
+static constexpr float GoldenTolerance = 1e-5f;
+
+// Largest allowed |n(p + d) - n(p)| / |d| for the continuity check. The kernels measure below 8.
+static constexpr float MaxSlope = 16.0f;
+static constexpr float ContinuityStep = 1e-3f;
+
+// Coordinates are drawn from [-SampleExtent, SampleExtent] so many lattice cells are covered
+static constexpr float SampleExtent = 256.0f;
+
+static float EvaluateNoise(int32 Dimension, const FVector4f& P)
+{
+	switch (Dimension)
+	{
+	case 1: return USimplexNoiseBPLibrary::SimplexNoise1D(P.X);
+	case 2: return USimplexNoiseBPLibrary::SimplexNoise2D(P.X, P.Y);
+	case 3: return USimplexNoiseBPLibrary::SimplexNoise3D(P.X, P.Y, P.Z);
+	default: return USimplexNoiseBPLibrary::SimplexNoise4D(P.X, P.Y, P.Z, P.W);
+	}
+}
+
+static FVector4f RandomPoint(FRandomStream& Stream)
+{
+	return FVector4f(
+		Stream.FRandRange(-SampleExtent, SampleExtent),
+		Stream.FRandRange(-SampleExtent, SampleExtent),
+		Stream.FRandRange(-SampleExtent, SampleExtent),
+		Stream.FRandRange(-SampleExtent, SampleExtent));
+}
+
+// Samples per dimension for the range and continuity checks
+static constexpr int32 NumRandomSamples = 262144;
+
+// The golden table holds for GoldenSeed, and reseeding rebuilds the same table
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetNoiseDeterminismTest, "PlanetGenerator.Noise.Determinism",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetNoiseDeterminismTest::RunTest(const FString& Parameters)
+{
+	USimplexNoiseBPLibrary::SetNoiseSeed(GoldenSeed);
+	for (int32 Point = 0; Point < UE_ARRAY_COUNT(GoldenPoints); Point++)
+	{
+		const FVector4f P(GoldenPoints[Point][0], GoldenPoints[Point][1], GoldenPoints[Point][2], GoldenPoints[Point][3]);
+		for (int32 Dimension = 1; Dimension <= 4; Dimension++)
+		{
+			TestEqual(FString::Printf(TEXT("%dD golden point %d"), Dimension, Point), EvaluateNoise(Dimension, P), GoldenValues[Point][Dimension - 1], GoldenTolerance);
+		}
+	}
+
+	// Another seed must change the output, and going back must restore it exactly
+	const float Reference = USimplexNoiseBPLibrary::SimplexNoise3D(GoldenPoints[1][0], GoldenPoints[1][1], GoldenPoints[1][2]);
+	USimplexNoiseBPLibrary::SetNoiseSeed(GoldenSeed + 1);
+	const float Reseeded = USimplexNoiseBPLibrary::SimplexNoise3D(GoldenPoints[1][0], GoldenPoints[1][1], GoldenPoints[1][2]);
+	USimplexNoiseBPLibrary::SetNoiseSeed(GoldenSeed);
+	const float Restored = USimplexNoiseBPLibrary::SimplexNoise3D(GoldenPoints[1][0], GoldenPoints[1][1], GoldenPoints[1][2]);
+
+	TestNotEqual(FString::Printf(TEXT("Seed %d against seed %d"), GoldenSeed + 1, GoldenSeed), Reseeded, Reference);
+	TestEqual(FString::Printf(TEXT("Reseeding with %d"), GoldenSeed), Restored, Reference);
+	return true;
+}
+
+// Every dimension stays inside [-1, 1]; logs the observed peak so scale factors can be tuned
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetNoiseRangeTest, "PlanetGenerator.Noise.Range",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetNoiseRangeTest::RunTest(const FString& Parameters)
+{
+	USimplexNoiseBPLibrary::SetNoiseSeed(GoldenSeed);
+	for (int32 Dimension = 1; Dimension <= 4; Dimension++)
+	{
+		FRandomStream Stream(Dimension);
+		float MinValue = 0.0f;
+		float MaxValue = 0.0f;
+		for (int32 i = 0; i < NumRandomSamples; i++)
+		{
+			const float Value = EvaluateNoise(Dimension, RandomPoint(Stream));
+			MinValue = FMath::Min(MinValue, Value);
+			MaxValue = FMath::Max(MaxValue, Value);
+		}
+
+		AddInfo(FString::Printf(TEXT("%dD range [%f, %f]"), Dimension, MinValue, MaxValue));
+		TestTrue(FString::Printf(TEXT("%dD range inside [-1, 1]"), Dimension), MinValue >= -1.0f && MaxValue <= 1.0f);
+	}
+
+	// FBM is normalised by its amplitude sum, so it keeps the range of the 3D kernel
+	FRandomStream Stream(5);
+	float Peak = 0.0f;
+	for (int32 i = 0; i < NumRandomSamples; i++)
+	{
+		const FVector4f P = RandomPoint(Stream);
+		Peak = FMath::Max(Peak, FMath::Abs(USimplexNoiseBPLibrary::SimplexNoiseFBM(P.X, P.Y, P.Z, 6, 0.5f, 2.0f)));
+	}
+
+	AddInfo(FString::Printf(TEXT("FBM peak %f"), Peak));
+	TestTrue(TEXT("FBM peak inside [-1, 1]"), Peak <= 1.0f);
+	return true;
+}
+
+// Small steps in a random direction give small changes in value
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetNoiseContinuityTest, "PlanetGenerator.Noise.Continuity",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetNoiseContinuityTest::RunTest(const FString& Parameters)
+{
+	USimplexNoiseBPLibrary::SetNoiseSeed(GoldenSeed);
+	for (int32 Dimension = 1; Dimension <= 4; Dimension++)
+	{
+		FRandomStream Stream(Dimension + 16);
+		float Steepest = 0.0f;
+		for (int32 i = 0; i < NumRandomSamples; i++)
+		{
+			const FVector4f P = RandomPoint(Stream);
+			FVector4f Direction(Stream.FRandRange(-1.0f, 1.0f), Stream.FRandRange(-1.0f, 1.0f), Stream.FRandRange(-1.0f, 1.0f), Stream.FRandRange(-1.0f, 1.0f));
+			Direction = Direction.GetSafeNormal() * ContinuityStep;
+
+			// Only the first Dimension components move the sample
+			const float StepLength = FVector4f(Direction.X, Dimension > 1 ? Direction.Y : 0.0f, Dimension > 2 ? Direction.Z : 0.0f, Dimension > 3 ? Direction.W : 0.0f).Size();
+			if (StepLength <= KINDA_SMALL_NUMBER * ContinuityStep)
+			{
+				continue;
+			}
+
+			const float Delta = FMath::Abs(EvaluateNoise(Dimension, P + Direction) - EvaluateNoise(Dimension, P));
+			Steepest = FMath::Max(Steepest, Delta / StepLength);
+		}
+
+		AddInfo(FString::Printf(TEXT("%dD steepest slope %f"), Dimension, Steepest));
+		TestTrue(FString::Printf(TEXT("%dD steepest slope below %f"), Dimension, MaxSlope), Steepest <= MaxSlope);
+	}
+	return true;
+}
+
+// The batched entry points return exactly what the scalar ones do
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlanetNoiseBatchTest, "PlanetGenerator.Noise.Batches",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPlanetNoiseBatchTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumPoints = 65536;
+
+	USimplexNoiseBPLibrary::SetNoiseSeed(GoldenSeed);
+	FRandomStream Stream(32);
+	TArray<FVector> Points;
+	Points.SetNumUninitialized(NumPoints);
+	for (FVector& Point : Points)
+	{
+		const FVector4f P = RandomPoint(Stream);
+		Point = FVector(P.X, P.Y, P.Z);
+	}
+
+	TArray<float> Batch3D, BatchFBM;
+	Batch3D.SetNumUninitialized(NumPoints);
+	BatchFBM.SetNumUninitialized(NumPoints);
+	USimplexNoiseBPLibrary::SimplexNoise3DBatch(Points, Batch3D);
+	USimplexNoiseBPLibrary::SimplexNoiseFBMBatch(Points, 6, 0.5f, 2.0f, BatchFBM);
+
+	int32 Mismatches3D = 0;
+	int32 MismatchesFBM = 0;
+	for (int32 i = 0; i < NumPoints; i++)
+	{
+		const FVector& P = Points[i];
+		Mismatches3D += Batch3D[i] != USimplexNoiseBPLibrary::SimplexNoise3D(P.X, P.Y, P.Z);
+		MismatchesFBM += BatchFBM[i] != USimplexNoiseBPLibrary::SimplexNoiseFBM(P.X, P.Y, P.Z, 6, 0.5f, 2.0f);
+	}
+
+	TestEqual(TEXT("Batched 3D mismatches"), Mismatches3D, 0);
+	TestEqual(TEXT("Batched FBM mismatches"), MismatchesFBM, 0);
+	return true;
+}
+
+#endif
@@ -4,8 +4,25 @@
 #include "GameFramework/Actor.h"
 #include "ProceduralMeshComponent.h"
 #include "SimplexNoiseBPLibrary.h"
+#include "PlanetTileGraph.h"
+#include "PlanetPathfinding.h"
+#include "PlanetSpatialIndex.h"
+#include "PlanetTileAttributes.h"
+#include "PlanetSurfaceSampler.h"
+#include "PlanetBiomeLookup.h"
+#include "PlanetSurfaceBake.h"
+#include "PlanetOceanShell.h"
+#include "PlanetImpostor.h"
+#include "PlanetGenerationStats.h"
 #include "PlanetActor.generated.h"
 
+struct FPlanetBuildSettings;
+struct FPlanetBuildResult;
+class APlanetActor;
+class UPlanetMeshComponent;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnPlanetGenerated, APlanetActor*, Planet, const FPlanetGenerationStats&, Stats);
+
 UENUM(BlueprintType)
 enum class EBiomeType : uint8
 {
@@ -19,6 +36,32 @@ enum class EBiomeType : uint8
 	Tundra UMETA(DisplayName = "Tundra")
 };
 
+// How biome colours reach the planet material
+UENUM(BlueprintType)
+enum class EPlanetColorMode : uint8
+{
+	// Final biome colours are baked into the vertex colours
+	BakedColors UMETA(DisplayName = "Baked Colors"),
+	// Vertex colours hold biome palette indices (R = slot / 255, G = blend weight, B = blend slot / 255)
+	// and the material reads colours and surface parameters from the BiomePalette texture. Needs a
+	// PlanetMaterial with that lookup; M_PlanetBase has none, so planets using it bake colours instead.
+	BiomePalette UMETA(DisplayName = "Biome Palette")
+};
+
+// What the planet collides with
+UENUM(BlueprintType)
+enum class EPlanetCollisionMode : uint8
+{
+	// Complex collision cooked from the full render mesh
+	RenderMesh UMETA(DisplayName = "Render Mesh"),
+	// Complex collision cooked from a coarser subdivision of the same terrain
+	LowResolution UMETA(DisplayName = "Low Resolution"),
+	// Analytic sphere at the planet radius, for background planets
+	Sphere UMETA(DisplayName = "Sphere"),
+	// No collision; tile selection by trace is unavailable
+	None UMETA(DisplayName = "None")
+};
+
 USTRUCT(BlueprintType)
 struct FBiomeSettings
 {
@@ -82,6 +125,60 @@ struct FNoiseLayer
 	float MinValue = 1.0f;
 };
 
+// Everything needed for one generation, applied to a planet before it first generates
+USTRUCT(BlueprintType)
+struct FPlanetGenerationParams
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Generation", meta = (UIMin = "1.0", UIMax = "10000.0"))
+	float PlanetRadius = 1000.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Generation", meta = (UIMin = "0", UIMax = "6"))
+	int32 Resolution = 4;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Generation")
+	int32 Seed = 1337;
+
+	// Replaces the planet's noise layers when not empty
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Noise")
+	TArray<FNoiseLayer> NoiseLayers;
+
+	// Replaces the planet's default biomes when not empty
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Biomes")
+	TArray<FBiomeSettings> Biomes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Climate")
+	float EquatorTemperature = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Climate")
+	float PoleTemperature = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Climate")
+	float MoistureScale = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Materials")
+	UMaterialInterface* PlanetMaterial = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Materials")
+	EPlanetColorMode ColorMode = EPlanetColorMode::BakedColors;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Ocean")
+	bool HasOcean = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Ocean", meta = (UIMin = "0.0", UIMax = "1.0"))
+	float OceanLevel = 0.3f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Ocean")
+	UMaterialInterface* OceanMaterial = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Collision")
+	EPlanetCollisionMode CollisionMode = EPlanetCollisionMode::RenderMesh;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Collision", meta = (UIMin = "0", UIMax = "6"))
+	int32 CollisionResolution = 3;
+};
+
 UCLASS(BlueprintType, Blueprintable)
 class PLANETGENERATOR_API APlanetActor : public AActor
 {
@@ -92,6 +189,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void OnConstruction(const FTransform& Transform) override;
 
 public:
@@ -100,6 +198,27 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Planet")
 	UProceduralMeshComponent* PlanetMesh;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Planet")
+	UProceduralMeshComponent* OceanMesh;
+
+	// Draws the surface instead of PlanetMesh when UsePlanetMeshComponent is set
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Planet")
+	UPlanetMeshComponent* PlanetSurface;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Planet")
+	class USphereComponent* CollisionSphere;
+
+	// Camera-facing quad drawn instead of the meshes while the planet is small on screen
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Planet")
+	class UMaterialBillboardComponent* ImpostorBillboard;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Collision")
+	EPlanetCollisionMode CollisionMode = EPlanetCollisionMode::RenderMesh;
+
+	// Subdivision level of the collision mesh in LowResolution mode, capped at Resolution
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Collision", meta = (UIMin = "0", UIMax = "6"))
+	int32 CollisionResolution = 3;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Generation", meta = (UIMin = "1.0", UIMax = "10000.0"))
 	float PlanetRadius = 1000.0f;
 
@@ -109,15 +228,43 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Generation")
 	bool AutoUpdate = true;
 
+	// Every random input of the generation comes from this; the same seed and settings give the same planet
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Generation")
 	int32 Seed = 1337;
 
+	// Sorts vertices along a space-filling curve and triangles for vertex cache reuse after subdivision.
+	// Tile indices follow the new triangle order, so they differ from an unoptimized planet's.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Planet|Generation")
+	bool OptimizeMeshOrder = false;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Noise")
 	TArray<FNoiseLayer> NoiseLayers;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Biomes")
 	TArray<FBiomeSettings> Biomes;
 
+	// Renders a low resolution water shell at OceanLevel and drops terrain triangles that lie entirely beneath it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Ocean")
+	bool HasOcean = false;
+
+	// Sea level as a normalized height, on the same scale as the biome height ranges
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Ocean", meta = (UIMin = "0.0", UIMax = "1.0", EditCondition = "HasOcean"))
+	float OceanLevel = 0.3f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Ocean", meta = (UIMin = "0", UIMax = "5", EditCondition = "HasOcean"))
+	int32 OceanResolution = 3;
+
+	// Falls back to UPlanetMaterialGenerator::CreateOceanMaterial when unset
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Ocean", meta = (EditCondition = "HasOcean"))
+	UMaterialInterface* OceanMaterial = nullptr;
+
+	UFUNCTION(BlueprintPure, Category = "Planet|Ocean")
+	float GetOceanRadius() const;
+
+	// Terrain triangles hidden under the ocean in the last generation
+	UFUNCTION(BlueprintPure, Category = "Planet|Ocean")
+	int32 GetSubmergedTriangleCount() const;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Climate")
 	float EquatorTemperature = 1.0f;
 
@@ -133,6 +280,12 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Materials")
 	bool TwoSidedMaterial = true;
 
+	// Draws the surface with PlanetSurface: the build packs render-ready streams that the component
+	// takes without copying, planets at the same resolution share index buffers, and tile highlights
+	// update only the changed colours. PlanetMesh then only holds LowResolution collision.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Planet|Materials")
+	bool UsePlanetMeshComponent = false;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Materials")
 	float AmbientOcclusion = 0.5f;
 
@@ -145,6 +298,156 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Materials")
 	bool GenerateVertexColors = true;
 
+	// BiomePalette lets biome colours change at runtime without regenerating the mesh
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Materials")
+	EPlanetColorMode ColorMode = EPlanetColorMode::BakedColors;
+
+	// Palette used in BiomePalette mode: row 0 biome colours, row 1 roughness/metallic/specular/emissive
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category = "Planet|Materials")
+	UTexture2D* BiomePaletteTexture = nullptr;
+
+	// Recolours every biome of the given type; in BiomePalette mode this only updates the palette
+	UFUNCTION(BlueprintCallable, Category = "Planet|Materials")
+	void SetBiomeColor(EBiomeType BiomeType, FLinearColor NewColor);
+
+	// Re-uploads the palette from the current biome settings, e.g. after editing BiomeMaterial parameters
+	UFUNCTION(BlueprintCallable, Category = "Planet|Materials")
+	void RefreshBiomePalette();
+
+	// Bakes height, normal and albedo cube-face textures after each generation, so a planet at
+	// Resolution 2-3 can take its surface detail from textures instead of vertices. Needs a
+	// PlanetMaterial sampling PlanetAlbedo, PlanetHeight and PlanetNormal; M_PlanetBase does not,
+	// so planets using it skip the bake.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Bake")
+	bool BakeSurfaceTextures = false;
+
+	// Texels per cube face edge
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Bake", meta = (UIMin = "16", UIMax = "2048", EditCondition = "BakeSurfaceTextures"))
+	int32 BakeFaceResolution = 256;
+
+	// Six-face strip atlases (+X, -X, +Y, -Y, +Z, -Z) of the last bake
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category = "Planet|Bake")
+	UTexture2D* BakedAlbedoTexture = nullptr;
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category = "Planet|Bake")
+	UTexture2D* BakedHeightTexture = nullptr;
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category = "Planet|Bake")
+	UTexture2D* BakedNormalTexture = nullptr;
+
+	// Bakes the surface textures now and binds them to the planet material when it samples them
+	UFUNCTION(BlueprintCallable, Category = "Planet|Bake")
+	bool BakeSurface();
+
+	// CPU copy of the last bake
+	const FPlanetSurfaceBake& GetSurfaceBake() const { return SurfaceBake; }
+
+#if WITH_EDITORONLY_DATA
+	// Folder for BakeToStaticMesh assets
+	UPROPERTY(EditAnywhere, Category = "Planet|Bake", meta = (ContentDir))
+	FDirectoryPath StaticMeshFolder;
+
+	// Asset name for BakeToStaticMesh; SM_<actor name> when empty
+	UPROPERTY(EditAnywhere, Category = "Planet|Bake")
+	FString StaticMeshName;
+
+	UPROPERTY(EditAnywhere, Category = "Planet|Bake")
+	bool StaticMeshNanite = true;
+
+	// LOD 0 plus reduced levels, each with half the triangles of the previous one
+	UPROPERTY(EditAnywhere, Category = "Planet|Bake", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 StaticMeshLODs = 3;
+
+	UPROPERTY(EditAnywhere, Category = "Planet|Bake")
+	bool StaticMeshCollision = true;
+#endif
+
+#if WITH_EDITOR
+	// Saves the generated surface as a UStaticMesh asset with final vertex colours and per-vertex
+	// biome data (UV1 = biome, height; UV2 = temperature, moisture), so it loads without generation
+	UFUNCTION(CallInEditor, Category = "Planet|Bake")
+	void BakeToStaticMesh();
+#endif
+
+	// Captures an octahedral albedo atlas after each generation and swaps the meshes for a
+	// sphere-shaded billboard while the planet covers less than ImpostorScreenSize of the screen
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Impostor")
+	bool UseImpostor = false;
+
+	// Atlas edge in texels
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Impostor", meta = (UIMin = "16", UIMax = "256", EditCondition = "UseImpostor"))
+	int32 ImpostorResolution = 64;
+
+	// Planet diameter as a fraction of the view width (horizontal field of view) below which the
+	// impostor is drawn
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Impostor", meta = (UIMin = "0.0", UIMax = "0.5", EditCondition = "UseImpostor"))
+	float ImpostorScreenSize = 0.03f;
+
+	// Colour of submerged areas in the atlas, standing in for the ocean shell
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Impostor", meta = (EditCondition = "UseImpostor"))
+	FLinearColor ImpostorOceanColor = FLinearColor(0.0f, 0.3f, 0.6f, 1.0f);
+
+	// Falls back to /PlanetGenerator/Materials/M_PlanetImpostor when unset; receives ImpostorAtlas
+	// and ImpostorResolution parameters. The plugin does not ship that material, so without one
+	// no atlas is baked and the planet never switches to its impostor.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Impostor", meta = (EditCondition = "UseImpostor"))
+	UMaterialInterface* ImpostorMaterial = nullptr;
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category = "Planet|Impostor")
+	UTexture2D* ImpostorTexture = nullptr;
+
+	// Shows the impostor in place of the planet and ocean meshes, or the meshes again
+	UFUNCTION(BlueprintCallable, Category = "Planet|Impostor")
+	void SetImpostorVisible(bool bVisible);
+
+	UFUNCTION(BlueprintPure, Category = "Planet|Impostor")
+	bool IsShowingImpostor() const { return bShowingImpostor; }
+
+	UFUNCTION(BlueprintPure, Category = "Planet|Impostor")
+	bool HasImpostor() const { return ImpostorTexture != nullptr && ImpostorMaterialInstance != nullptr; }
+
+	// Lets the world's memory governor lower this planet's resolution or hold it on its impostor
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Memory")
+	bool AllowMemoryGovernor = true;
+
+	// Scales the planet's screen size when the governor picks which planets to lower first
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Memory", meta = (UIMin = "0.0", UIMax = "10.0", EditCondition = "AllowMemoryGovernor"))
+	float MemoryImportance = 1.0f;
+
+	// Highest resolution the memory governor allows; INDEX_NONE when uncapped
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category = "Planet|Memory")
+	int32 GovernedResolution = INDEX_NONE;
+
+	// Set while the memory governor keeps the planet on its impostor at any screen size
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category = "Planet|Memory")
+	bool GovernorForcesImpostor = false;
+
+	// Resolution the planet asks for: Resolution, clamped to the calibrated preset in game worlds
+	UFUNCTION(BlueprintPure, Category = "Planet|Memory")
+	int32 GetTargetResolution() const;
+
+	// Resolution the next generation builds at, after the governor's cap
+	UFUNCTION(BlueprintPure, Category = "Planet|Memory")
+	int32 GetEffectiveResolution() const;
+
+	// Heap held by the generated geometry, query structures, mesh sections and the buffers kept
+	// for the next regeneration
+	UFUNCTION(BlueprintPure, Category = "Planet|Memory")
+	int64 GetGeometryMemorySize() const;
+
+	// Called by the memory governor; regenerates when the cap changes the built resolution
+	void SetMemoryGovernorState(int32 ResolutionCap, bool bForceImpostor);
+
+	// Heap held by the result and mesh streams kept for the next regeneration; included in GetGeometryMemorySize
+	int64 GetRecycledMemorySize() const;
+
+	// Seconds since the kept result was handed back, or -1 when none is kept
+	double GetRecycledAge() const;
+
+	// Frees the kept result and streams; the next generation allocates its buffers afresh. Called by the
+	// memory governor for planets that stay idle or when planets are over budget.
+	void ReleaseRecycledBuildResult();
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Debug")
 	bool ShowNormals = false;
 
@@ -160,6 +463,24 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Rotation", meta = (EditCondition = "AutoRotate"))
 	FVector RotationAxis = FVector(0.0f, 0.0f, 1.0f);
 
+	// Circles OrbitCenter at the planet's current distance
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Orbit")
+	bool AutoOrbit = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Orbit", meta = (EditCondition = "AutoOrbit"))
+	FVector OrbitCenter = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Orbit", meta = (EditCondition = "AutoOrbit"))
+	FVector OrbitAxis = FVector(0.0f, 0.0f, 1.0f);
+
+	// Degrees per second
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Orbit", meta = (UIMin = "0.0", UIMax = "90.0", EditCondition = "AutoOrbit"))
+	float OrbitSpeed = 5.0f;
+
+	// Rotation and orbit run in UPlanetSubsystem; call this after changing them at runtime
+	UFUNCTION(BlueprintCallable, Category = "Planet|Rotation")
+	void RefreshMotion();
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|TileSelection")
 	bool EnableTileSelection = true;
 
@@ -178,6 +499,22 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "Planet|TileSelection")
 	EBiomeType SelectedTileBiome;
 
+	// Movement cost multiplier per biome; zero or less makes the biome impassable
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pathfinding")
+	TMap<EBiomeType, float> BiomeMovementCosts;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pathfinding", meta = (UIMin = "0.0", UIMax = "10.0"))
+	float ElevationCostScale = 1.0f;
+
+	UFUNCTION(BlueprintCallable, Category = "Planet|Pathfinding")
+	bool FindTilePath(int32 StartTile, int32 GoalTile, TArray<int32>& OutPath, float& OutCost) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Planet|Pathfinding")
+	void FindTilePathsAsync(const TArray<FPlanetPathQuery>& Queries, FOnPlanetPathsFound OnComplete);
+
+	TSharedPtr<const FPlanetPathfinder> GetPathfinder() const { return Pathfinder; }
+	FPlanetPathCosts MakePathCosts() const;
+
 	UFUNCTION(BlueprintCallable, Category = "Planet|TileSelection")
 	bool SelectTileAtScreenPosition(APlayerController* PlayerController, FVector2D ScreenPosition);
 
@@ -190,22 +527,161 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Planet")
 	void GeneratePlanet();
 
+	// Broadcast after every generation has been applied, with its stage timings
+	UPROPERTY(BlueprintAssignable, Category = "Planet|Stats")
+	FOnPlanetGenerated OnPlanetGenerated;
+
+	// Timings of the last applied generation
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category = "Planet|Stats")
+	FPlanetGenerationStats LastGenerationStats;
+
+	// Hashes the positions, colours and biomes of every generation into GenerationHash and the log
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "Planet|Stats")
+	bool VerifyGeneration = false;
+
+	// Output hash of the last applied generation with VerifyGeneration set
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category = "Planet|Stats")
+	FString GenerationHash;
+
+	// Queues generation with the world's generation scheduler, or generates now where there is none
+	UFUNCTION(BlueprintCallable, Category = "Planet")
+	void RequestGeneration();
+
+	// Copies the parameters onto the planet without generating
+	UFUNCTION(BlueprintCallable, Category = "Planet")
+	void ApplyGenerationParams(const FPlanetGenerationParams& Params);
+
+	// Flags the planet for regeneration on the next tick; any number of changes in one frame cost one generation
+	UFUNCTION(BlueprintCallable, Category = "Planet")
+	void MarkGenerationDirty();
+
+	UFUNCTION(BlueprintPure, Category = "Planet")
+	bool IsGenerationDirty() const { return bGenerationDirty; }
+
+	// Generates now if changes are pending
+	UFUNCTION(BlueprintCallable, Category = "Planet")
+	void RegenerateIfDirty();
+
 	UFUNCTION(BlueprintCallable, Category = "Planet")
 	void ClearMesh();
 
-private:
-	void CreateIcosphere();
-	void SubdivideIcosphere(int32 Subdivisions);
-	float EvaluateNoise(const FVector& PointOnUnitSphere);
-	FVector CalculatePointOnPlanet(const FVector& PointOnUnitSphere);
-	float GetTemperature(const FVector& PointOnUnitSphere);
-	float GetMoisture(const FVector& PointOnUnitSphere);
-	EBiomeType DetermineBiome(float Height, float Temperature, float Moisture);
-	FLinearColor GetBiomeColor(EBiomeType BiomeType, float Height, float Temperature, float Moisture);
-	int32 GetMiddlePoint(int32 p1, int32 p2, TMap<FVector2D, int32>& Cache);
+	UFUNCTION(BlueprintPure, Category = "Planet|Topology")
+	int32 GetTileCount() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Planet|Topology")
+	TArray<int32> GetTileNeighbours(int32 TileIndex) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Planet|Topology")
+	TArray<int32> GetVertexNeighbours(int32 VertexIndex) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Planet|Topology")
+	TArray<int32> GetTileRing(int32 TileIndex, int32 Distance) const;
+
+	// Adjacency built during subdivision; shared so queries can outlive a regeneration
+	TSharedPtr<const FPlanetTileGraph> GetTileGraph() const { return TileGraph; }
+
+	TSharedPtr<const FPlanetSpatialIndex> GetSpatialIndex() const { return SpatialIndex; }
 
+	// Climate and biome values recorded during generation
+	TSharedPtr<const FPlanetTileAttributes> GetTileAttributes() const { return Attributes; }
+
+	UFUNCTION(BlueprintPure, Category = "Planet|Attributes")
+	float GetTileHeight(int32 TileIndex) const;
+
+	UFUNCTION(BlueprintPure, Category = "Planet|Attributes")
+	float GetTileTemperature(int32 TileIndex) const;
+
+	UFUNCTION(BlueprintPure, Category = "Planet|Attributes")
+	float GetTileMoisture(int32 TileIndex) const;
+
+	UFUNCTION(BlueprintPure, Category = "Planet|Attributes")
+	EBiomeType GetTileBiome(int32 TileIndex) const;
+
+	UFUNCTION(BlueprintPure, Category = "Planet|Attributes")
+	EBiomeType GetVertexBiome(int32 VertexIndex) const;
+
+	// Copies the attributes of every tile
+	UFUNCTION(BlueprintCallable, Category = "Planet|Attributes")
+	void GetAllTileAttributes(TArray<float>& OutHeights, TArray<float>& OutTemperatures, TArray<float>& OutMoistures, TArray<EBiomeType>& OutBiomes) const;
+
+	// Copies the attributes of the given tiles, e.g. the result of a region query
+	UFUNCTION(BlueprintCallable, Category = "Planet|Attributes")
+	void GetTileAttributesForTiles(const TArray<int32>& TileIndices, TArray<float>& OutHeights, TArray<float>& OutTemperatures, TArray<float>& OutMoistures, TArray<EBiomeType>& OutBiomes) const;
+
+	// Sampler over the current mesh; safe to use from worker threads and across regenerations
+	TSharedPtr<const FPlanetSurfaceSampler> GetSurfaceSampler() const { return SurfaceSampler; }
+
+	// Surface position, normal and biome along each direction from the planet centre (directions in planet local space)
+	UFUNCTION(BlueprintCallable, Category = "Planet|Sampling")
+	bool SampleSurface(const TArray<FVector>& Directions, TArray<FVector>& OutLocations, TArray<FVector>& OutNormals, TArray<EBiomeType>& OutBiomes, bool bWorldSpace = true) const;
+
+	UFUNCTION(BlueprintPure, Category = "Planet|Regions")
+	int32 FindTileAtLocation(FVector WorldLocation) const;
+
+	// Tiles whose centres are within Radius of the location, measured along the surface
+	UFUNCTION(BlueprintCallable, Category = "Planet|Regions")
+	TArray<int32> GetTilesInRadius(FVector WorldLocation, float Radius) const;
+
+	// Connected tiles sharing the biome of the seed tile
+	UFUNCTION(BlueprintCallable, Category = "Planet|Regions")
+	TArray<int32> FloodFillBiome(int32 SeedTile) const;
+
+	// Connected tiles whose height lies within [MinHeight, MaxHeight]
+	UFUNCTION(BlueprintCallable, Category = "Planet|Regions")
+	TArray<int32> FloodFillElevation(int32 SeedTile, float MinHeight, float MaxHeight) const;
+
+	// Labels connected regions of equal biome; returns the number of regions
+	UFUNCTION(BlueprintCallable, Category = "Planet|Regions")
+	int32 LabelBiomeRegions(TArray<int32>& OutLabels) const;
+
+	// Labels connected regions on either side of the height threshold (e.g. continents and seas)
+	UFUNCTION(BlueprintCallable, Category = "Planet|Regions")
+	int32 LabelElevationRegions(float Threshold, TArray<int32>& OutLabels) const;
+
+	// Snapshot of the generation settings for FPlanetMeshBuilder
+	FPlanetBuildSettings MakeBuildSettings() const;
+
+	// Takes the settings snapshot for a build about to start and clears the dirty flag
+	FPlanetBuildSettings BeginGeneration();
+
+	// Moves a finished build into the components; game thread only
+	void ApplyBuildResult(FPlanetBuildResult&& Result);
+
+	// Build target for the next generation, holding the buffers of the one before last when
+	// available so a regeneration reuses their capacity
+	TSharedPtr<FPlanetBuildResult> TakeBuildResult();
+
+	// Hands back an applied result for TakeBuildResult to reuse
+	void RecycleBuildResult(TSharedPtr<FPlanetBuildResult> Result);
+
+private:
 	TArray<FLinearColor> OriginalVertexColors;
 	bool UpdateSelectedTileVisual();
+	void BuildOcean(TSharedPtr<const FPlanetOceanShell> Shell);
+	void BuildCollision(const FPlanetBuildResult& Result);
+	void ApplyCollisionSettings();
+	bool UsesRenderMeshCollision() const { return CollisionMode == EPlanetCollisionMode::RenderMesh; }
+	void BuildBiomePalette(TArray<FLinearColor>& OutColors, TArray<FLinearColor>& OutSurfaceParameters) const;
+	void ApplyBiomePalette();
+	void UploadSurfaceBake();
+	void ApplyImpostor(const FPlanetImpostorAtlas& Atlas);
+	UMaterialInterface* GetImpostorMaterial() const;
+
+	// Whether a Blueprint subclass implements Event Tick, which must keep running
+	bool HasScriptTick() const;
+	void ApplySurfaceBake();
+	UMaterialInstanceDynamic* GetSurfaceMaterialInstance();
+	UMaterialInterface* GetSurfaceMaterial() const;
+
+	// Whether the material the surface is drawn with samples the given texture parameter
+	bool SurfaceMaterialHasTexture(FName ParameterName) const;
+
+	// Component drawing the surface: PlanetSurface or PlanetMesh
+	UMeshComponent* GetSurfaceComponent() const;
+
+	// Sends VertexColors to the drawn surface; only the listed vertices when the surface supports it
+	void UploadVertexColors(TArrayView<const int32> ChangedVertices);
+
 	int32 FindTriangleIndexFromHitLocation(const FVector& HitLocation);
 
 	UPROPERTY()
@@ -234,7 +710,57 @@ private:
 	// Store the selected triangle vertices in local space
 	TArray<FVector> SelectedTriangleVertices;
 
-	// Store triangles separately to ensure they're preserved
+	// Triangles handed to the mesh section; Triangles minus those under the ocean, or empty when
+	// nothing is culled (see GetRenderTriangles)
 	UPROPERTY()
-	TArray<int32> StoredTriangles;
+	TArray<int32> RenderTriangles;
+
+	const TArray<int32>& GetRenderTriangles() const { return RenderTriangles.Num() > 0 ? RenderTriangles : Triangles; }
+
+	// Hidden mesh section holding the LowResolution collision mesh
+	static constexpr int32 CollisionSectionIndex = 1;
+
+	// Ocean shell resolution currently uploaded to OceanMesh
+	int32 OceanMeshResolution = INDEX_NONE;
+
+	UPROPERTY(Transient)
+	UMaterialInterface* DefaultOceanMaterial = nullptr;
+
+	// Triangle across each edge of each triangle, tracked through subdivision
+	UPROPERTY()
+	TArray<int32> TriangleNeighbours;
+
+	TSharedPtr<const FPlanetTileGraph> TileGraph;
+
+	TSharedPtr<const FPlanetTileAttributes> Attributes;
+
+	TSharedPtr<const FPlanetPathfinder> Pathfinder;
+
+	TSharedPtr<const FPlanetSpatialIndex> SpatialIndex;
+
+	TSharedPtr<const FPlanetSurfaceSampler> SurfaceSampler;
+
+	// Biome table of the current mesh, used to resolve palette slots
+	FBiomeLookupTable BiomeLookup;
+
+	// Set by MarkGenerationDirty, cleared when a build takes its settings snapshot
+	bool bGenerationDirty = false;
+
+	// Whether the current mesh was generated with palette indices in its vertex colours
+	bool bMeshUsesBiomePalette = false;
+
+	// Dynamic instance of PlanetMaterial carrying the palette and baked texture parameters
+	UPROPERTY(Transient)
+	UMaterialInstanceDynamic* SurfaceMaterialInstance = nullptr;
+
+	FPlanetSurfaceBake SurfaceBake;
+
+	UPROPERTY(Transient)
+	UMaterialInstanceDynamic* ImpostorMaterialInstance = nullptr;
+
+	bool bShowingImpostor = false;
+
+	// Applied result kept for its capacity; see TakeBuildResult
+	TSharedPtr<FPlanetBuildResult> RecycledBuildResult;
+	double RecycledTime = 0.0;
 };
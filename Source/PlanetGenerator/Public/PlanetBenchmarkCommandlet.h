@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PlanetBenchmarkCommandlet.generated.h"
+
+// Headless generation benchmark. Builds planets across a matrix of settings with FPlanetMeshBuilder
+// and writes one CSV row per run, so it works with -nullrhi on machines without a GPU.
+//
+//   UnrealEditor-Cmd <Project> -run=PlanetBenchmark -nullrhi -unattended
+//     -Resolutions=0-8 -Layers=1,2,4 -Octaves=4,8 -OptimizeOrder=0,1 -Workers=1,4,0 -Concurrency=1,4
+//     -Iterations=3 -Output=<file.csv>
+//
+// Lists take comma-separated values or inclusive ranges. Workers caps the task graph workers each
+// build's tasks may occupy (FPlanetBuildSettings::MaxWorkers); 0 means all of them. Concurrency is
+// the number of planets built at the same time on the thread pool, matching how the generation
+// scheduler runs builds. Each row records the task graph's worker count alongside both.
+// OptimizeOrder=1 runs reorder the mesh and report its cache miss ratios before and after.
+UCLASS()
+class PLANETGENERATOR_API UPlanetBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPlanetBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	// Parses "1,2,4", "0-8" or a mix of both
+	static TArray<int32> ParseIntList(const FString& Text);
+};
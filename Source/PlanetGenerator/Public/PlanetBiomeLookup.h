@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FBiomeSettings;
+enum class EBiomeType : uint8;
+
+// Biome list compiled into a quantized height x temperature x moisture grid.
+// Each cell stores the biome slot that wins for every point in the cell under the first-match
+// rule of APlanetActor::DetermineBiome. Cells cut by a biome boundary are marked ambiguous and
+// fall back to scanning the compiled bounds, so results are identical to the linear scan.
+class PLANETGENERATOR_API FBiomeLookupTable
+{
+public:
+	static constexpr int32 GridResolution = 32;
+
+	void Build(const TArray<FBiomeSettings>& Biomes);
+	void Reset();
+
+	bool IsBuilt() const { return Cells.Num() > 0; }
+
+	// Index into the biome list the table was built from, or INDEX_NONE when no biome matches
+	int32 Classify(float Height, float Temperature, float Moisture) const;
+
+	// Biome type for a slot; no match resolves to Plains like DetermineBiome
+	EBiomeType GetBiomeType(int32 Slot) const;
+
+	// Colour for a slot, resolved the same way as GetBiomeColor (first biome of the slot's type)
+	const FLinearColor& GetColor(int32 Slot) const;
+
+	int32 GetNumSlots() const { return Bounds.Num(); }
+
+private:
+	// Low bits hold a slot; ambiguous cells hold the first slot that could match
+	static constexpr uint16 NoMatchCell = 0x7FFF;
+	static constexpr uint16 AmbiguousFlag = 0x8000;
+
+	struct FBiomeBounds
+	{
+		float MinHeight, MaxHeight;
+		float MinTemperature, MaxTemperature;
+		float MinMoisture, MaxMoisture;
+	};
+
+	int32 ScanBounds(float Height, float Temperature, float Moisture, int32 FirstSlot = 0) const;
+
+	static int32 ToCell(float Value)
+	{
+		return FMath::Clamp(FMath::FloorToInt(Value * GridResolution), 0, GridResolution - 1);
+	}
+
+	TArray<uint16> Cells;
+	TArray<FBiomeBounds> Bounds;
+	TArray<EBiomeType> SlotTypes;
+
+	// One colour per slot, plus the no-match colour in the last entry
+	TArray<FLinearColor> SlotColors;
+};
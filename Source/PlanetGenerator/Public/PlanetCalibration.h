@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "PlanetCalibration.generated.h"
+
+// Quality presets measured on this machine. The first game world with auto calibration enabled
+// builds a reference planet on a worker thread, once to warm up and then three times at each of
+// two octave counts (seven builds in all), fits the cost per vertex and per noise octave from the
+// fastest runs, and picks the highest resolution and octave count whose predicted build time meets the
+// target. The result is saved to the user's GameUserSettings, so later runs skip the measurement
+// until the core count or the target changes.
+UCLASS(config = GameUserSettings)
+class PLANETGENERATOR_API UPlanetCalibration : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Highest resolution planets build at on this machine; INDEX_NONE before calibration
+	UPROPERTY(config, VisibleAnywhere, BlueprintReadOnly, Category = "Planet|Calibration")
+	int32 MaxResolution = INDEX_NONE;
+
+	// Most octaves a noise layer samples on this machine
+	UPROPERTY(config, VisibleAnywhere, BlueprintReadOnly, Category = "Planet|Calibration")
+	int32 MaxOctaves = INDEX_NONE;
+
+	// Fitted cost of one vertex outside the noise, and of one noise octave at one vertex
+	UPROPERTY(config, VisibleAnywhere, BlueprintReadOnly, Category = "Planet|Calibration")
+	float MicrosecondsPerVertex = 0.0f;
+
+	UPROPERTY(config, VisibleAnywhere, BlueprintReadOnly, Category = "Planet|Calibration")
+	float MicrosecondsPerOctave = 0.0f;
+
+	// Machine and target the presets were measured for
+	UPROPERTY(config)
+	int32 CalibratedCores = 0;
+
+	UPROPERTY(config)
+	float CalibratedTargetMs = 0.0f;
+
+	// Starts a measurement unless the stored presets still match this machine and target. The
+	// builds run on a worker thread and the presets are applied and saved on the game thread
+	// once they finish; until then the stored presets, if any, stay in effect.
+	static void EnsureCalibrated(bool bForce = false);
+
+	// Whether a measurement started by EnsureCalibrated has yet to be applied; game thread only
+	static bool IsCalibrating();
+
+	// Whether planets in game worlds should be clamped to the presets
+	static bool IsActive();
+
+	// Predicted build time of the reference planet at a resolution with octaves per layer
+	float PredictBuildMs(int32 Resolution, int32 Octaves, int32 NumLayers) const;
+
+private:
+	// Picks the presets for the fitted costs and saves them
+	void ApplyCosts(float InMicrosecondsPerVertex, float InMicrosecondsPerOctave, int32 NumLayers, int32 ReferenceOctaves);
+};
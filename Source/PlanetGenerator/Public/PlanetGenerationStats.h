@@ -0,0 +1,147 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "PlanetGenerationStats.generated.h"
+
+DECLARE_STATS_GROUP(TEXT("PlanetGenerator"), STATGROUP_PlanetGenerator, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build"), STAT_PlanetBuild, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Subdivision"), STAT_PlanetSubdivision, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Reorder"), STAT_PlanetReorder, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Topology"), STAT_PlanetTopology, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Noise"), STAT_PlanetNoise, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Climate"), STAT_PlanetClimate, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Biomes"), STAT_PlanetBiomes, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tangents"), STAT_PlanetTangents, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ocean"), STAT_PlanetOcean, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Collision"), STAT_PlanetCollision, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bake"), STAT_PlanetBake, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Collision Setup"), STAT_PlanetCollisionSetup, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Upload"), STAT_PlanetUpload, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply"), STAT_PlanetApply, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tile Selection"), STAT_PlanetTileSelection, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Vertices"), STAT_PlanetVertices, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles"), STAT_PlanetTriangles, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Geometry Memory"), STAT_PlanetGeometryMemory, STATGROUP_PlanetGenerator, PLANETGENERATOR_API);
+
+// Timing of one generation, filled by FPlanetMeshBuilder on the build thread and by
+// APlanetActor::ApplyBuildResult on the game thread. Stages that did not run stay at zero.
+// Topology and the per-vertex stages run as overlapping tasks, so their times are summed work
+// and together can exceed BuildMs.
+USTRUCT(BlueprintType)
+struct PLANETGENERATOR_API FPlanetGenerationStats
+{
+	GENERATED_BODY()
+
+	// Icosphere creation and subdivision
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float SubdivisionMs = 0.0f;
+
+	// Vertex and triangle reordering when OptimizeMeshOrder is set
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float ReorderMs = 0.0f;
+
+	// Tile graph and spatial index
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float TopologyMs = 0.0f;
+
+	// Terrain noise, positions, normals and UVs
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float NoiseMs = 0.0f;
+
+	// Temperature and moisture
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float ClimateMs = 0.0f;
+
+	// Biome classification, colours, tile attributes and the pathfinder
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float BiomeMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float TangentsMs = 0.0f;
+
+	// Submerged triangle culling
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float OceanMs = 0.0f;
+
+	// Low resolution collision mesh, on the build thread
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float CollisionMs = 0.0f;
+
+	// Surface and impostor bakes
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float BakeMs = 0.0f;
+
+	// Whole build, on whichever thread ran it
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float BuildMs = 0.0f;
+
+	// Mesh section creation on the game thread
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float UploadMs = 0.0f;
+
+	// Collision sections and settings on the game thread
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float CollisionSetupMs = 0.0f;
+
+	// All game-thread work of applying the build, including UploadMs and CollisionSetupMs
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float ApplyMs = 0.0f;
+
+	// Subdivision level the planet was built at
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	int32 Resolution = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	int32 NumVertices = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	int32 NumTriangles = 0;
+
+	// Average cache miss ratio of the triangle order before and after reordering, through a
+	// FPlanetMeshOrder::VertexCacheSize entry FIFO cache. Zero when the mesh was not reordered.
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float VertexCacheMissRatioBefore = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float VertexCacheMissRatioAfter = 0.0f;
+
+	// Data cache lines fetched per triangle when reading the unit vertices in triangle order,
+	// before and after reordering. Zero when the mesh was not reordered.
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float VertexFetchMissesBefore = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	float VertexFetchMissesAfter = 0.0f;
+
+	// Heap held by the generated arrays and query structures
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Stats")
+	int64 BytesAllocated = 0;
+};
+
+// Accumulates the lifetime of the scope into a stats field in milliseconds
+struct FPlanetStageTimer
+{
+	explicit FPlanetStageTimer(float& InMilliseconds)
+		: Milliseconds(InMilliseconds)
+		, StartTime(FPlatformTime::Seconds())
+	{
+	}
+
+	~FPlanetStageTimer()
+	{
+		Milliseconds += (float)((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
+	float& Milliseconds;
+	double StartTime;
+};
+
+// Insights event, STAT cycle counter and stats field for one generation stage
+#define PLANET_STAGE_SCOPE(Stage, Milliseconds) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Planet_##Stage); \
+	SCOPE_CYCLE_COUNTER(STAT_Planet##Stage); \
+	FPlanetStageTimer PlanetStageTimer_##Stage(Milliseconds)
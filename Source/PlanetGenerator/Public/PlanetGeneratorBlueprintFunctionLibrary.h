@@ -14,6 +14,17 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Planet Generator")
 	static APlanetActor* CreatePlanet(UObject* WorldContextObject, FVector Location, FRotator Rotation, float Radius = 1000.0f, int32 Resolution = 4);
 	
+	// Spawns deferred, applies every parameter and generates exactly once
+	UFUNCTION(BlueprintCallable, Category = "Planet Generator")
+	static APlanetActor* CreatePlanetWithParams(UObject* WorldContextObject, FVector Location, FRotator Rotation, const FPlanetGenerationParams& Params);
+
+	UFUNCTION(BlueprintPure, Category = "Planet Generator")
+	static FNoiseLayer MakeNoiseLayer(float Strength = 1.0f, int32 NumLayers = 4, float BaseRoughness = 1.0f, float Roughness = 2.0f, float Persistence = 0.5f);
+
+	UFUNCTION(BlueprintPure, Category = "Planet Generator")
+	static FBiomeSettings MakeBiome(EBiomeType BiomeType, FLinearColor BiomeColor, float MinHeight = 0.0f, float MaxHeight = 1.0f, float MinTemperature = 0.0f, float MaxTemperature = 1.0f, float MinMoisture = 0.0f, float MaxMoisture = 1.0f);
+
+	// The setters below mark the planet dirty; it regenerates once on the next tick
 	UFUNCTION(BlueprintCallable, Category = "Planet Generator")
 	static void AddNoiseLayer(APlanetActor* Planet, float Strength = 1.0f, int32 NumLayers = 4, float BaseRoughness = 1.0f, float Roughness = 2.0f, float Persistence = 0.5f);
 	
@@ -14,6 +14,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Planet Generator")
 	static APlanetActor* SpawnPlanetActor(UObject* WorldContextObject, FVector Location, FRotator Rotation, float Radius = 1000.0f, int32 Resolution = 4);
 	
+	// The setters below mark the planet dirty; it regenerates once on the next tick
 	UFUNCTION(BlueprintCallable, Category = "Planet Generator")
 	static void SetPlanetNoiseParameters(APlanetActor* PlanetActor, int32 NoiseLayerIndex, float Strength, int32 NumLayers, float BaseRoughness, float Roughness, float Persistence);
 	
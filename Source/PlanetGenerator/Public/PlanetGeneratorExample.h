@@ -53,5 +53,5 @@ private:
 	UPROPERTY()
 	APlanetActor* Planet;
 	
-	void AddDefaultBiomes();
+	void AddDefaultBiomes(FPlanetGenerationParams& Params);
 };
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "PlanetGeneratorSettings.generated.h"
+
+// Project-wide planet generation settings, under Project Settings > Plugins > Planet Generator
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "Planet Generator"))
+class PLANETGENERATOR_API UPlanetGeneratorSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UPlanetGeneratorSettings();
+
+	// Build planets on worker threads in game worlds and apply them under a frame budget
+	UPROPERTY(config, EditAnywhere, Category = "Scheduler")
+	bool bUseGenerationScheduler = true;
+
+	// Game-thread time per frame for applying finished builds; at least one is applied per frame
+	UPROPERTY(config, EditAnywhere, Category = "Scheduler", meta = (ClampMin = "0.1", Units = "ms"))
+	float GenerationFrameBudgetMs = 4.0f;
+
+	// Planets building on worker threads at the same time
+	UPROPERTY(config, EditAnywhere, Category = "Scheduler", meta = (ClampMin = "1"))
+	int32 MaxConcurrentBuilds = 2;
+
+	// Heap all planets in a game world may hold for generated geometry; 0 leaves resolution alone.
+	// Over budget, the least important planets are lowered, then held on their impostors.
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (ClampMin = "0", Units = "Megabytes"))
+	int32 PlanetMemoryBudgetMB = 0;
+
+	// Lowest resolution the memory governor lowers a planet to before it falls back to the impostor
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (ClampMin = "0", ClampMax = "6"))
+	int32 MinGovernedResolution = 2;
+
+	// Time between memory governor passes
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (ClampMin = "0.0", Units = "s"))
+	float MemoryGovernorInterval = 1.0f;
+
+	// Time a planet keeps its last build's buffers for a regeneration before the memory governor
+	// frees them. Planets over budget lose them at once.
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (ClampMin = "0.0", Units = "s"))
+	float RecycledBuildLifetime = 10.0f;
+
+	// Measure this machine once and clamp planet resolution and octaves in game worlds to what
+	// builds within TargetGenerationMs. Results are kept in the user's GameUserSettings.
+	UPROPERTY(config, EditAnywhere, Category = "Calibration")
+	bool bAutoCalibrate = false;
+
+	// Build time one planet should stay within on the calibrated machine
+	UPROPERTY(config, EditAnywhere, Category = "Calibration", meta = (ClampMin = "1.0", Units = "ms", EditCondition = "bAutoCalibrate"))
+	float TargetGenerationMs = 100.0f;
+
+	// Resolution of the reference planet built during calibration
+	UPROPERTY(config, EditAnywhere, Category = "Calibration", meta = (ClampMin = "1", ClampMax = "6", EditCondition = "bAutoCalibrate"))
+	int32 CalibrationResolution = 4;
+
+	// Highest resolution and octave count calibration may pick
+	UPROPERTY(config, EditAnywhere, Category = "Calibration", meta = (ClampMin = "0", ClampMax = "10", EditCondition = "bAutoCalibrate"))
+	int32 MaxCalibratedResolution = 8;
+
+	UPROPERTY(config, EditAnywhere, Category = "Calibration", meta = (ClampMin = "1", ClampMax = "16", EditCondition = "bAutoCalibrate"))
+	int32 MaxCalibratedOctaves = 8;
+};
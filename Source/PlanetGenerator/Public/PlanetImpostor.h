@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Planet albedo captured into a square octahedral atlas for distant rendering. The impostor
+// material reconstructs the sphere normal on a camera-facing quad, converts it to planet space
+// and looks the colour up with OctahedralEncode, so one small texture covers every view angle.
+struct PLANETGENERATOR_API FPlanetImpostorAtlas
+{
+	int32 Resolution = 0;
+
+	// Surface colour in sRGB; alpha holds the clamped normalized height for rim and water shading
+	TArray<FColor> Albedo;
+
+	bool IsValid() const { return Resolution > 0 && Albedo.Num() == Resolution * Resolution; }
+
+	void Reset();
+
+	// Unit direction to [0, 1] atlas coordinates; the lower hemisphere folds into the corners
+	static FVector2D OctahedralEncode(const FVector& Direction);
+	static FVector OctahedralDecode(const FVector2D& UV);
+};
+
+class PLANETGENERATOR_API FPlanetImpostorBaker
+{
+public:
+	// ElevationAt and AlbedoAt are called concurrently and must be thread-safe
+	static void Bake(int32 Resolution,
+		TFunctionRef<float(const FVector&)> ElevationAt,
+		TFunctionRef<FLinearColor(const FVector&, float)> AlbedoAt,
+		FPlanetImpostorAtlas& OutAtlas);
+};
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "PixelFormat.h"
 #include "PlanetMaterialGenerator.generated.h"
 
 UCLASS()
@@ -27,6 +28,26 @@ public:
                                                         float Opacity = 0.7f,
                                                         bool TwoSided = true);
 
+	// Palette texture for biome-indexed vertex colours: row 0 holds biome colours,
+	// row 1 holds surface parameters (roughness, metallic, specular, emissive strength)
+	static constexpr int32 BiomePaletteWidth = 256;
+
+	UFUNCTION(BlueprintCallable, Category = "Planet Generator|Materials")
+	static UTexture2D* CreateBiomePaletteTexture(const TArray<FLinearColor>& Colors, const TArray<FLinearColor>& SurfaceParameters);
+
+	UFUNCTION(BlueprintCallable, Category = "Planet Generator|Materials")
+	static void UpdateBiomePaletteTexture(UTexture2D* PaletteTexture, const TArray<FLinearColor>& Colors, const TArray<FLinearColor>& SurfaceParameters);
+
+	// Parent material of CreatePlanetMaterial: M_PlanetBase, or the engine's default surface material
+	static UMaterialInterface* GetPlanetBaseMaterial();
+
+	// Whether Material or one of its parents declares the texture parameter. Used to skip features
+	// whose data no material would sample.
+	static bool HasTextureParameter(const UMaterialInterface* Material, FName ParameterName);
+
+	// Transient texture filled from raw pixel data, e.g. a baked cube-face strip atlas
+	static UTexture2D* CreateDataTexture(int32 Width, int32 Height, EPixelFormat Format, const void* Data, int32 BytesPerPixel, bool bSRGB);
+
 	UFUNCTION(BlueprintCallable, Category = "Planet Generator|Materials")
 	static UMaterialInstanceDynamic* CreateBiomeMaterial(UObject* WorldContextObject, 
                                                         FLinearColor BaseColor, 
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralMeshComponent.h"
+#include "PlanetActor.h"
+#include "PlanetImpostor.h"
+#include "PlanetGenerationStats.h"
+#include "PlanetMeshComponent.h"
+
+// Snapshot of the planet settings one generation reads. Taken on the game thread so the
+// build itself never touches the actor.
+struct PLANETGENERATOR_API FPlanetBuildSettings
+{
+	float PlanetRadius = 1000.0f;
+	int32 Resolution = 4;
+
+	// Source of every random input; layer offsets are derived from it
+	int32 Seed = 1337;
+
+	TArray<FNoiseLayer> NoiseLayers;
+	TArray<FBiomeSettings> Biomes;
+
+	float EquatorTemperature = 1.0f;
+	float PoleTemperature = 0.0f;
+	float MoistureScale = 1.0f;
+
+	EPlanetColorMode ColorMode = EPlanetColorMode::BakedColors;
+
+	bool HasOcean = false;
+	float OceanLevel = 0.3f;
+	int32 OceanResolution = 3;
+
+	EPlanetCollisionMode CollisionMode = EPlanetCollisionMode::RenderMesh;
+	int32 CollisionResolution = 3;
+
+	bool BakeSurfaceTextures = false;
+	int32 BakeFaceResolution = 256;
+
+	// Octahedral impostor atlas edge in texels; 0 skips the impostor
+	int32 ImpostorResolution = 0;
+	FLinearColor ImpostorOceanColor = FLinearColor(0.0f, 0.3f, 0.6f, 1.0f);
+
+	// Fills FPlanetBuildResult::OutputHash
+	bool bComputeOutputHash = false;
+
+	// Reorders the subdivision for cache locality before anything reads it (see FPlanetMeshOrder).
+	// Tile indices follow the new triangle order.
+	bool bOptimizeMeshOrder = false;
+
+	// Packs FPlanetBuildResult::RenderStreams for UPlanetMeshComponent
+	bool bBuildRenderStreams = false;
+
+	// Most of the build's own tasks run at once; 0 leaves them to the whole worker pool and 1 runs
+	// the build on the calling thread. The surface and impostor bakes are not limited.
+	int32 MaxWorkers = 0;
+};
+
+// Everything a generation produces before it reaches the components. A result can be built
+// into again: Build resets it without releasing capacity, so a recycled result makes a
+// regeneration at the same resolution reuse its arrays instead of allocating new ones.
+struct PLANETGENERATOR_API FPlanetBuildResult
+{
+	// Subdivided unit sphere and the displaced surface, in planet local space
+	TArray<FVector> UnitVertices;
+	TArray<FVector> Positions;
+	TArray<int32> Triangles;
+	TArray<int32> TriangleNeighbours;
+
+	// Triangles minus those hidden under the ocean. Empty when nothing was culled, so the common
+	// case keeps one index list instead of two; a planet drowned entirely draws every triangle,
+	// which the ocean hides.
+	TArray<int32> RenderTriangles;
+
+	TArray<FVector> Normals;
+	TArray<FVector2D> UV0;
+	TArray<FLinearColor> VertexColors;
+	TArray<FProcMeshTangent> Tangents;
+
+	// The surface packed for UPlanetMeshComponent when bBuildRenderStreams is set
+	FPlanetMeshStreams RenderStreams;
+
+	// Key under which planets share the index buffer of RenderTriangles: the same for every
+	// planet drawing the whole subdivision at one level and order, INDEX_NONE once the ocean
+	// has culled triangles of this planet only
+	int32 IndexBufferKey = INDEX_NONE;
+
+	FBiomeLookupTable BiomeLookup;
+	bool bUsesBiomePalette = false;
+
+	TSharedPtr<const FPlanetTileGraph> TileGraph;
+	TSharedPtr<const FPlanetSpatialIndex> SpatialIndex;
+	TSharedPtr<const FPlanetTileAttributes> Attributes;
+	TSharedPtr<const FPlanetPathfinder> Pathfinder;
+	TSharedPtr<const FPlanetSurfaceSampler> SurfaceSampler;
+
+	// Shell drawn at sea level; null without an ocean
+	TSharedPtr<const FPlanetOceanShell> OceanShell;
+
+	// LowResolution collision mesh; empty in the other collision modes
+	TArray<FVector> CollisionVertices;
+	TArray<int32> CollisionTriangles;
+
+	// Filled when BakeSurfaceTextures is set
+	FPlanetSurfaceBake SurfaceBake;
+
+	// Filled when ImpostorResolution is set
+	FPlanetImpostorAtlas Impostor;
+
+	FPlanetGenerationStats Stats;
+
+	// SHA-1 of the positions, vertex colours and biomes when bComputeOutputHash is set
+	FString OutputHash;
+
+	// Hashes the generated surface; equal hashes mean the same planet
+	FString ComputeOutputHash() const;
+
+	// Ping-pong buffers of the subdivision, kept with the result so their capacity is reused
+	TArray<int32> ScratchTriangles;
+	TArray<int32> ScratchNeighbours;
+	TArray<int32> ScratchMidpoints;
+
+	// Empties every output while keeping array capacity
+	void Reset();
+
+	// Heap held by the arrays above and the shared query structures
+	SIZE_T GetAllocatedSize() const;
+};
+
+// Runs the CPU side of planet generation: subdivision, noise, climate, biomes and the derived
+// query structures. The builder only reads its settings snapshot, so Build can run on any thread.
+class PLANETGENERATOR_API FPlanetMeshBuilder
+{
+public:
+	// Palette slot reserved for the tile selection highlight
+	static constexpr int32 HighlightPaletteSlot = 255;
+
+	explicit FPlanetMeshBuilder(const FPlanetBuildSettings& InSettings);
+
+	void Build(FPlanetBuildResult& OutResult) const;
+
+	// Bakes the cube-face textures of the surface (see FPlanetSurfaceBaker)
+	void BakeSurface(int32 FaceResolution, FPlanetSurfaceBake& OutBake) const;
+
+	// Captures the surface into an octahedral atlas, with submerged areas in the ocean colour
+	void BakeImpostor(int32 Resolution, FPlanetImpostorAtlas& OutAtlas) const;
+
+	float EvaluateNoise(const FVector& PointOnUnitSphere) const;
+	FVector CalculatePointOnPlanet(const FVector& PointOnUnitSphere) const;
+	float GetTemperature(const FVector& PointOnUnitSphere) const;
+	float GetMoisture(const FVector& PointOnUnitSphere) const;
+	EBiomeType DetermineBiome(float Height, float Temperature, float Moisture) const;
+	FLinearColor GetBiomeColor(EBiomeType BiomeType) const;
+
+	// Biome colour at a direction for a raw noise elevation, resolved like the mesh vertices
+	FLinearColor GetSurfaceAlbedo(const FVector& PointOnUnitSphere, float Elevation) const;
+
+	// Sea level radius for the settings' OceanLevel
+	float GetOceanRadius() const;
+
+	// Whether vertex colours will carry biome palette indices
+	bool UsesBiomePalette() const;
+
+	const FBiomeLookupTable& GetBiomeLookup() const { return BiomeLookup; }
+
+private:
+	static void CreateIcosphere(FPlanetBuildResult& Result);
+	static void SubdivideIcosphere(FPlanetBuildResult& Result, int32 Subdivisions);
+	static void OptimizeMeshOrder(FPlanetBuildResult& Result);
+
+	void EncodeBiomePalette(TArrayView<const uint8> PaletteSlots, FPlanetBuildResult& Result) const;
+	void CullSubmergedTriangles(FPlanetBuildResult& Result) const;
+	void BuildLowResolutionCollision(FPlanetBuildResult& Result) const;
+
+	FPlanetBuildSettings Settings;
+
+	// Per-layer sample offset derived from the seed, added to each layer's Center
+	TArray<FVector> LayerOffsets;
+
+	// Biomes compiled once per generation for per-vertex classification
+	FBiomeLookupTable BiomeLookup;
+};
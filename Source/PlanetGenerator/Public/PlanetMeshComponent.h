@@ -0,0 +1,125 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/MeshComponent.h"
+#include "Interfaces/Interface_CollisionDataProvider.h"
+#include "PackedNormal.h"
+#include "PlanetMeshComponent.generated.h"
+
+class FPlanetIndexBuffer;
+class UBodySetup;
+
+// Vertex streams of a planet surface in the layout FLocalVertexFactory fetches, packed on the
+// build thread so the game thread never converts them
+struct PLANETGENERATOR_API FPlanetMeshStreams
+{
+	TArray<FVector3f> Positions;
+
+	// TangentX then TangentZ of each vertex; TangentZ is the normal with the binormal sign in W
+	TArray<FPackedNormal> TangentBasis;
+
+	TArray<FVector2f> TexCoords;
+	TArray<FColor> Colors;
+
+	int32 Num() const { return Positions.Num(); }
+
+	// Sizes every stream for NumVertices, keeping capacity
+	void SetNum(int32 NumVertices);
+
+	// Empties every stream while keeping capacity
+	void Reset();
+
+	SIZE_T GetAllocatedSize() const;
+};
+
+// Draws a planet surface from streams the build packed, without the copies through
+// FProcMeshSection that UProceduralMeshComponent makes. The component takes the streams by move
+// and shares them with its scene proxy, which keeps them for as long as its buffers live. Only
+// the colours change afterwards; the proxy holds its own copy of those and patches it over
+// ranges. Render mesh collision is cooked from the same streams.
+UCLASS(ClassGroup = Rendering, meta = (BlueprintSpawnableComponent))
+class PLANETGENERATOR_API UPlanetMeshComponent : public UMeshComponent, public IInterface_CollisionDataProvider
+{
+	GENERATED_BODY()
+
+public:
+	UPlanetMeshComponent(const FObjectInitializer& ObjectInitializer);
+
+	// Index buffer for a set of render triangles. Buffers created with the same SharedKey are
+	// reused while any planet still draws one, so callers only pass a key for triangle lists that
+	// are identical for it; INDEX_NONE always makes a new buffer.
+	static TSharedRef<FPlanetIndexBuffer, ESPMode::ThreadSafe> FindOrCreateIndexBuffer(TArrayView<const int32> Triangles, int32 SharedKey = INDEX_NONE);
+
+	// Takes the streams by move and draws them with the index buffer. InStreams is left empty,
+	// or holding the arrays of an earlier mesh no proxy draws any more, for the caller to refill.
+	void SetMesh(FPlanetMeshStreams&& InStreams, TSharedRef<FPlanetIndexBuffer, ESPMode::ThreadSafe> InIndexBuffer, bool bCreateCollision);
+
+	void ClearMesh();
+
+	// Overwrites the colours from FirstVertex on, on the CPU copy and on the GPU
+	void UpdateVertexColors(int32 FirstVertex, TArrayView<const FColor> NewColors);
+
+	// Overwrites the colour of each of Vertices with the matching entry of NewColors. The vertices
+	// are merged into ranges and reach the render thread in one command.
+	void UpdateVertexColors(TArrayView<const int32> Vertices, TArrayView<const FColor> NewColors);
+
+	int32 GetNumVertices() const { return Streams.IsValid() ? Streams->Num() : 0; }
+
+	// Heap held by the streams and the index buffer's CPU copy
+	SIZE_T GetMeshAllocatedSize() const;
+
+	// Heap held by the streams of replaced meshes, kept to take the next mesh's arrays
+	SIZE_T GetRetiredStreamsAllocatedSize() const;
+
+	void ReleaseRetiredStreams() { RetiredStreams.Reset(); }
+
+	TSharedPtr<const FPlanetMeshStreams, ESPMode::ThreadSafe> GetStreams() const { return Streams; }
+	TSharedPtr<FPlanetIndexBuffer, ESPMode::ThreadSafe> GetIndexBuffer() const { return IndexBuffer; }
+
+	//~ Begin UPrimitiveComponent Interface
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual UBodySetup* GetBodySetup() override;
+	//~ End UPrimitiveComponent Interface
+
+	//~ Begin UMeshComponent Interface
+	virtual int32 GetNumMaterials() const override { return 1; }
+	//~ End UMeshComponent Interface
+
+	//~ Begin IInterface_CollisionDataProvider Interface
+	virtual bool GetPhysicsTriMeshData(FTriMeshCollisionData* CollisionData, bool InUseAllTriData) override;
+	virtual bool ContainsPhysicsTriMeshData(bool InUseAllTriData) const override;
+	virtual bool WantsNegXTriMesh() override { return false; }
+	//~ End IInterface_CollisionDataProvider Interface
+
+private:
+	//~ Begin USceneComponent Interface
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	//~ End USceneComponent Interface
+
+	// Hands colour ranges (first vertex, count) already written to Streams to the scene proxy
+	void SendColorRanges(TArray<FIntPoint>&& Ranges);
+
+	// Moves Streams to the retired list, keeping the two newest
+	void RetireStreams();
+
+	void UpdateCollision();
+	void FinishCollisionCook(bool bSuccess, UBodySetup* FinishedBodySetup);
+
+	TSharedPtr<FPlanetMeshStreams, ESPMode::ThreadSafe> Streams;
+
+	// Earlier Streams, oldest first; each is reused once the scene proxy that drew it lets go. The
+	// newest is usually still drawn when the next mesh arrives, so two are kept.
+	TArray<TSharedPtr<FPlanetMeshStreams, ESPMode::ThreadSafe>, TInlineAllocator<2>> RetiredStreams;
+	TSharedPtr<FPlanetIndexBuffer, ESPMode::ThreadSafe> IndexBuffer;
+
+	FBox LocalBounds = FBox(ForceInit);
+
+	bool bCollisionFromMesh = false;
+
+	UPROPERTY(Transient)
+	UBodySetup* BodySetup = nullptr;
+
+	// Cooking in the background; replaces BodySetup when done unless a newer mesh arrived
+	UPROPERTY(Transient)
+	UBodySetup* PendingBodySetup = nullptr;
+};
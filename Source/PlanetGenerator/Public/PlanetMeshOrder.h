@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Cache-friendly orderings of a triangle mesh, and the measures used to compare them.
+// Subdivision numbers vertices in the order edges are split and emits triangles level by level,
+// so neighbours on the sphere end up far apart in both arrays. Sorting vertices along a
+// space-filling curve keeps neighbours close in memory for the CPU passes, and reordering the
+// triangles keeps recently used vertices in the GPU's post-transform cache.
+struct PLANETGENERATOR_API FPlanetMeshOrder
+{
+	// Post-transform cache entries the triangle order is tuned for and measured with
+	static constexpr int32 VertexCacheSize = 16;
+
+	// 64 byte lines in the simulated data cache; 32 KiB, a typical L1
+	static constexpr int32 DataCacheLines = 512;
+
+	// Vertex order along a Hilbert curve over the six faces of the cube the directions project onto
+	static void SortVerticesAlongCurve(TArrayView<const FVector> UnitVertices, TArray<int32>& OutOrder);
+
+	// Triangles fanned per cluster when ordering them for the vertex cache
+	static constexpr int32 TrianglesPerCluster = 1024;
+
+	// Triangle order for a FIFO vertex cache of CacheSize entries (Tipsify), run over clusters of
+	// triangles taken in order of their lowest vertex. With a curve-sorted vertex order each
+	// cluster is a compact patch, so the order also keeps the vertex reads local.
+	static void OptimizeTriangleOrder(TArrayView<const int32> Triangles, int32 NumVertices, int32 CacheSize, TArray<int32>& OutOrder);
+
+	// Average cache miss ratio: vertices transformed per triangle through a FIFO cache. 3 is the
+	// worst case and 0.5 the limit for a large closed mesh.
+	static float ComputeACMR(TArrayView<const int32> Triangles, int32 NumVertices, int32 CacheSize = VertexCacheSize);
+
+	// Data cache lines fetched per triangle when vertices of VertexStride bytes are read in index
+	// order through an 8-way LRU cache of CacheLines lines
+	static float ComputeFetchMisses(TArrayView<const int32> Triangles, int32 VertexStride, int32 CacheLines = DataCacheLines);
+};
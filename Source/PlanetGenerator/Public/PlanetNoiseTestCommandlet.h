@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PlanetNoiseTestCommandlet.generated.h"
+
+// Microbenchmarks for the simplex noise kernels: logs ns/sample for each scalar and batched kernel.
+//
+//   UnrealEditor-Cmd <Project> -run=PlanetNoiseTest -nullrhi -unattended [-Samples=1000000]
+//
+// The accuracy checks (output range, continuity, reseeding, batched against scalar and the seed
+// 1337 golden table) are the PlanetGenerator.Noise automation tests.
+UCLASS()
+class PLANETGENERATOR_API UPlanetNoiseTestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPlanetNoiseTestCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
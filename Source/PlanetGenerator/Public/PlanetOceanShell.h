@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Unit icosphere used as the ocean surface and as the base of low resolution collision.
+// One shell per resolution is shared by every planet; each planet scales or displaces a copy.
+struct PLANETGENERATOR_API FPlanetOceanShell
+{
+	TArray<FVector> Positions;
+	TArray<int32> Triangles;
+	TArray<FVector2D> UVs;
+
+	// Distance from the centre to the closest face plane. Anything inside this radius
+	// (scaled by the sea level radius) is hidden under the shell.
+	float InscribedRadius = 1.0f;
+
+	static TSharedRef<const FPlanetOceanShell> Get(int32 Resolution);
+
+private:
+	void Build(int32 Resolution);
+};
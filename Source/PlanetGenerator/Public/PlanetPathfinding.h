@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlanetTileGraph.h"
+#include "PlanetTileAttributes.h"
+#include "PlanetPathfinding.generated.h"
+
+USTRUCT(BlueprintType)
+struct FPlanetPathQuery
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pathfinding")
+	int32 StartTile = -1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Planet|Pathfinding")
+	int32 GoalTile = -1;
+};
+
+USTRUCT(BlueprintType)
+struct FPlanetPathResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pathfinding")
+	bool bFound = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pathfinding")
+	float Cost = 0.0f;
+
+	// Tiles from start to goal, both included
+	UPROPERTY(BlueprintReadOnly, Category = "Planet|Pathfinding")
+	TArray<int32> Tiles;
+};
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnPlanetPathsFound, const TArray<FPlanetPathResult>&, Results);
+
+// Movement cost multipliers indexed by biome; a cost of zero or less makes a biome impassable
+struct FPlanetPathCosts
+{
+	float BiomeCosts[256];
+	float ElevationCostScale = 1.0f;
+
+	FPlanetPathCosts()
+	{
+		for (float& Cost : BiomeCosts)
+		{
+			Cost = 1.0f;
+		}
+	}
+
+	float GetMinPassableCost() const;
+};
+
+// A* search over the tile graph of one generated planet.
+// The pathfinder is immutable once built, so searches can run on any thread while the
+// planet regenerates; search scratch (open heap, scores and closed stamps) is pooled.
+class PLANETGENERATOR_API FPlanetPathfinder : public TSharedFromThis<FPlanetPathfinder>
+{
+public:
+	FPlanetPathfinder() = default;
+	FPlanetPathfinder(TSharedPtr<const FPlanetTileGraph> InTileGraph, TSharedPtr<const FPlanetTileAttributes> InAttributes, float InPlanetRadius);
+	~FPlanetPathfinder();
+
+	// Prepares searches over a new graph, keeping the edge length and scratch allocations. Only
+	// for a pathfinder nothing else references, since searches read it without locking.
+	void Build(TSharedPtr<const FPlanetTileGraph> InTileGraph, TSharedPtr<const FPlanetTileAttributes> InAttributes, float InPlanetRadius);
+
+	// Lets go of the graph and attributes, keeping the same allocations as Build
+	void Reset();
+
+	bool FindPath(int32 StartTile, int32 GoalTile, const FPlanetPathCosts& Costs, FPlanetPathResult& OutResult) const;
+
+	// Runs all queries on worker threads and calls OnComplete on the game thread with results in query order
+	void FindPathsAsync(TArray<FPlanetPathQuery> Queries, const FPlanetPathCosts& Costs, TFunction<void(TArray<FPlanetPathResult>&&)> OnComplete) const;
+
+	int32 GetNumTiles() const { return TileGraph.IsValid() ? TileGraph->GetNumTiles() : 0; }
+
+	// Heap held by the edge lengths and the pooled search scratch; the shared tile graph and
+	// attributes are not included
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FSearchScratch;
+
+	FSearchScratch* AcquireScratch() const;
+	void ReleaseScratch(FSearchScratch* Scratch) const;
+
+	float GreatCircleDistance(int32 TileA, int32 TileB) const;
+
+	TSharedPtr<const FPlanetTileGraph> TileGraph;
+	TSharedPtr<const FPlanetTileAttributes> Attributes;
+
+	// Great-circle length of each graph edge, parallel to FPlanetTileGraph::TileNeighbours
+	TArray<float> EdgeLengths;
+
+	float PlanetRadius = 0.0f;
+
+	mutable FCriticalSection ScratchLock;
+	mutable TArray<FSearchScratch*> ScratchPool;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlanetTileGraph.h"
+
+// Point location and cap queries over the tiles of one generated planet.
+// A cube-map grid maps a direction to a nearby starting tile, and a short greedy walk
+// over the tile graph finishes the lookup, so queries never scan every tile.
+class PLANETGENERATOR_API FPlanetSpatialIndex
+{
+public:
+	FPlanetSpatialIndex() = default;
+	explicit FPlanetSpatialIndex(TSharedPtr<const FPlanetTileGraph> InTileGraph);
+
+	// Indexes InTileGraph in place of whatever was indexed before, keeping the grid's capacity
+	void Build(TSharedPtr<const FPlanetTileGraph> InTileGraph);
+
+	// Empties the index and lets go of its graph, keeping the grid's capacity
+	void Reset();
+
+	// Tile whose centre is closest to the direction (need not be normalized)
+	int32 FindNearestTile(const FVector& Direction) const;
+
+	// Tiles whose centres lie within AngleRadians of the direction, i.e. inside a spherical cap
+	void GetTilesInCap(const FVector& Direction, float AngleRadians, TArray<int32>& OutTiles) const;
+
+	// Cube-map face (0..5: +X, -X, +Y, -Y, +Z, -Z) and face coordinates in [0, 1] for a direction
+	static int32 DirectionToCubeFace(const FVector& Direction, float& OutU, float& OutV);
+
+	// Inverse of DirectionToCubeFace; returns a unit direction
+	static FVector CubeFaceToDirection(int32 Face, float U, float V);
+
+	// Heap held by the cell grid; the tile graph is not included
+	SIZE_T GetAllocatedSize() const { return CellTiles.GetAllocatedSize(); }
+
+private:
+	int32 GetCellIndex(const FVector& Direction) const;
+
+	TSharedPtr<const FPlanetTileGraph> TileGraph;
+
+	// Cells per cube face edge, and the tile closest to each cell's centre
+	int32 GridSize = 1;
+	TArray<int32> CellTiles;
+
+	// Largest angle between adjacent tile centres, used as the margin when growing caps
+	float MaxNeighbourAngle = 0.0f;
+};
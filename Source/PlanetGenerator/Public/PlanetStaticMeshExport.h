@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralMeshComponent.h"
+
+#if WITH_EDITOR
+
+class UStaticMesh;
+class UMaterialInterface;
+struct FPlanetTileAttributes;
+
+struct PLANETGENERATOR_API FPlanetStaticMeshExportSettings
+{
+	// Long package name of the asset, e.g. /Game/Planets/SM_Planet
+	FString PackageName;
+
+	bool bEnableNanite = true;
+
+	// LOD 0 plus NumLODs - 1 reduced levels, each with half the triangles of the previous one
+	int32 NumLODs = 1;
+
+	// Cooks the render triangles as complex-as-simple collision
+	bool bGenerateCollision = true;
+
+	bool bSavePackage = true;
+};
+
+// Surface of a generated planet, in planet local space
+struct PLANETGENERATOR_API FPlanetStaticMeshSource
+{
+	TArrayView<const FVector> Positions;
+	TArrayView<const int32> Triangles;
+	TArrayView<const FVector> Normals;
+	TArrayView<const FVector2D> UV0;
+	TArrayView<const FLinearColor> VertexColors;
+	TArrayView<const FProcMeshTangent> Tangents;
+
+	// Per-vertex climate written to UV1 (biome, height) and UV2 (temperature, moisture)
+	const FPlanetTileAttributes* Attributes = nullptr;
+
+	UMaterialInterface* Material = nullptr;
+};
+
+// Editor-only conversion of a generated planet into a regular static mesh asset
+class PLANETGENERATOR_API FPlanetStaticMeshExporter
+{
+public:
+	static UStaticMesh* Export(const FPlanetStaticMeshSource& Source, const FPlanetStaticMeshExportSettings& Settings);
+};
+
+#endif
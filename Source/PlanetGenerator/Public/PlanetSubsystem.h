@@ -0,0 +1,104 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Async/Future.h"
+#include "PlanetSubsystem.generated.h"
+
+class APlanetActor;
+struct FPlanetBuildResult;
+
+// Drives the rotation and orbit of every moving planet in a world from a single tick.
+// Motion settings are copied into a flat array when a planet registers or calls RefreshMotion,
+// so planets themselves only tick while they have per-frame work of their own.
+// Also schedules planet generation: requests are built on worker threads, largest on screen
+// first, and finished builds are applied within a per-frame game-thread budget.
+// Planets with an impostor are swapped to it while they are small on screen.
+// With a memory budget set, a governor caps the resolution of the least important planets, and
+// then holds them on their impostors, until the planets' geometry fits the budget.
+UCLASS()
+class PLANETGENERATOR_API UPlanetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// Adds, updates or removes the planet depending on whether it rotates or orbits
+	void UpdatePlanet(APlanetActor* Planet);
+
+	void RemovePlanet(APlanetActor* Planet);
+
+	UFUNCTION(BlueprintPure, Category = "Planet|Motion")
+	int32 GetNumMovingPlanets() const { return Planets.Num(); }
+
+	// Queues a build of the planet's current settings, replacing any older request for it
+	void RequestGeneration(APlanetActor* Planet);
+
+	// Drops queued and running builds of the planet, e.g. when it generates synchronously
+	void CancelGeneration(APlanetActor* Planet);
+
+	// Tracks the planet for impostor switching while it has an impostor atlas
+	void UpdateImpostor(APlanetActor* Planet);
+
+	// Planets queued or building
+	UFUNCTION(BlueprintPure, Category = "Planet|Generation")
+	int32 GetNumPendingGenerations() const { return QueuedBuilds.Num() + RunningBuilds.Num(); }
+
+	// Geometry heap of every planet in the world at the last governor pass
+	UFUNCTION(BlueprintPure, Category = "Planet|Memory")
+	int64 GetPlanetGeometryMemory() const { return PlanetGeometryBytes; }
+
+private:
+	struct FPlanetBuildJob
+	{
+		TWeakObjectPtr<APlanetActor> Planet;
+		uint32 RequestId = 0;
+		float Priority = 0.0f;
+		TFuture<TSharedPtr<FPlanetBuildResult>> Result;
+	};
+
+	void TickGeneration();
+	void TickImpostors();
+	void TickMemoryGovernor(float DeltaTime);
+
+	// Projected size of the planet from the first player's camera; larger builds first
+	float GetGenerationPriority(const APlanetActor* Planet) const;
+
+	bool IsLatestRequest(const FPlanetBuildJob& Job) const;
+
+	TArray<FPlanetBuildJob> QueuedBuilds;
+	TArray<FPlanetBuildJob> RunningBuilds;
+
+	// Planets with an impostor atlas, switched by screen size every tick
+	TArray<TWeakObjectPtr<APlanetActor>> ImpostorPlanets;
+
+	// Newest request per planet; builds of older requests are dropped when they finish
+	TMap<TWeakObjectPtr<APlanetActor>, uint32> LatestRequests;
+	uint32 NextRequestId = 1;
+
+	float GovernorElapsed = 0.0f;
+	int64 PlanetGeometryBytes = 0;
+
+	struct FPlanetMotion
+	{
+		// Spin about a local axis, in radians per second
+		FVector RotationAxis = FVector::UpVector;
+		float RotationSpeed = 0.0f;
+
+		// Orbit of the planet's offset from OrbitCenter about OrbitAxis, in radians per second
+		bool bOrbit = false;
+		FVector OrbitCenter = FVector::ZeroVector;
+		FVector OrbitAxis = FVector::UpVector;
+		FVector OrbitOffset = FVector::ZeroVector;
+		float OrbitSpeed = 0.0f;
+		float OrbitAngle = 0.0f;
+	};
+
+	// Parallel arrays, one entry per moving planet
+	TArray<TWeakObjectPtr<APlanetActor>> Planets;
+	TArray<FPlanetMotion> Motions;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Surface detail baked into cube-face textures, laid out as a strip atlas of the six faces
+// (+X, -X, +Y, -Y, +Z, -Z) that is FaceResolution * 6 texels wide and FaceResolution high.
+// Face coordinates follow FPlanetSpatialIndex::DirectionToCubeFace.
+struct PLANETGENERATOR_API FPlanetSurfaceBake
+{
+	int32 FaceResolution = 0;
+
+	// Raw noise elevation; the surface radius is PlanetRadius * (1 + Elevation * HeightScale)
+	TArray<float> Heights;
+
+	// Biome colours in sRGB
+	TArray<FColor> Albedo;
+
+	// Planet-space surface normals packed as Normal * 0.5 + 0.5
+	TArray<FColor> Normals;
+
+	int32 GetWidth() const { return FaceResolution * 6; }
+	int32 GetHeight() const { return FaceResolution; }
+
+	bool IsValid() const { return FaceResolution > 0 && Heights.Num() == GetWidth() * GetHeight(); }
+
+	void Reset();
+};
+
+// Evaluates a planet's surface functions into an FPlanetSurfaceBake on worker threads.
+// ElevationAt and AlbedoAt are called concurrently and must be thread-safe.
+class PLANETGENERATOR_API FPlanetSurfaceBaker
+{
+public:
+	static void Bake(int32 FaceResolution, float HeightScale,
+		TFunctionRef<float(const FVector&)> ElevationAt,
+		TFunctionRef<FLinearColor(const FVector&, float)> AlbedoAt,
+		FPlanetSurfaceBake& OutBake);
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlanetTileGraph.h"
+#include "PlanetSpatialIndex.h"
+#include "PlanetTileAttributes.h"
+
+// One surface sample in planet local space
+struct FPlanetSurfaceSample
+{
+	FVector Position = FVector::ZeroVector;
+	FVector Normal = FVector::UpVector;
+	int32 TileIndex = INDEX_NONE;
+	uint8 Biome = 0;
+};
+
+// Samples the generated surface along directions from the planet centre by intersecting the cached mesh
+// and interpolating barycentrically. The sampler keeps its own copy of the mesh and is immutable,
+// so it can be used from worker threads while the planet regenerates.
+class PLANETGENERATOR_API FPlanetSurfaceSampler
+{
+public:
+	FPlanetSurfaceSampler() = default;
+	FPlanetSurfaceSampler(const TArray<FVector>& InPositions, const TArray<int32>& InTriangles, TSharedPtr<const FPlanetTileGraph> InTileGraph, TSharedPtr<const FPlanetSpatialIndex> InSpatialIndex, TSharedPtr<const FPlanetTileAttributes> InAttributes);
+
+	// Copies a new mesh into the arrays of the old one, keeping their capacity
+	void Build(const TArray<FVector>& InPositions, const TArray<int32>& InTriangles, TSharedPtr<const FPlanetTileGraph> InTileGraph, TSharedPtr<const FPlanetSpatialIndex> InSpatialIndex, TSharedPtr<const FPlanetTileAttributes> InAttributes);
+
+	// Empties the mesh copy and lets go of the shared structures, keeping the arrays' capacity
+	void Reset();
+
+	bool IsValid() const { return SpatialIndex.IsValid() && Triangles.Num() > 0; }
+
+	// Direction is in planet local space and need not be normalized
+	FPlanetSurfaceSample Sample(const FVector& Direction) const;
+
+	// Samples every direction, splitting the batch across worker threads
+	void SampleBatch(TArrayView<const FVector> Directions, TArrayView<FPlanetSurfaceSample> OutSamples) const;
+
+	// Heap held by the sampler's own copy of the mesh; the shared structures are not included
+	SIZE_T GetAllocatedSize() const { return Positions.GetAllocatedSize() + Triangles.GetAllocatedSize(); }
+
+private:
+	// Ray from the centre through Tile; returns false if the ray misses the triangle
+	bool IntersectTile(int32 Tile, const FVector& Direction, FVector& OutBarycentric, float& OutDistance) const;
+
+	TArray<FVector> Positions;
+	TArray<int32> Triangles;
+
+	TSharedPtr<const FPlanetTileGraph> TileGraph;
+	TSharedPtr<const FPlanetSpatialIndex> SpatialIndex;
+	TSharedPtr<const FPlanetTileAttributes> Attributes;
+};
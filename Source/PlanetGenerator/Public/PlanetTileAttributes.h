@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Climate and biome data produced by GeneratePlanet, stored as structure-of-arrays.
+// Vertex arrays are indexed like the mesh vertices, tile arrays like the tiles (triangles).
+// Heights are normalized to [0, 1] exactly as used for biome classification; biomes hold EBiomeType values.
+struct PLANETGENERATOR_API FPlanetTileAttributes
+{
+	TArray<float> VertexHeights;
+	TArray<float> VertexTemperatures;
+	TArray<float> VertexMoistures;
+	TArray<uint8> VertexBiomes;
+
+	TArray<float> TileHeights;
+	TArray<float> TileTemperatures;
+	TArray<float> TileMoistures;
+	TArray<uint8> TileBiomes;
+
+	void SetNumVertices(int32 NumVertices);
+
+	// Averages the corner values of every triangle and classifies the result with Classify(Height, Temperature, Moisture)
+	void BuildTiles(const TArray<int32>& Triangles, TFunctionRef<uint8(float, float, float)> Classify);
+
+	void Reset();
+
+	int32 GetNumVertices() const { return VertexHeights.Num(); }
+	int32 GetNumTiles() const { return TileHeights.Num(); }
+
+	bool IsValidTile(int32 TileIndex) const { return TileIndex >= 0 && TileIndex < GetNumTiles(); }
+	bool IsValidVertex(int32 VertexIndex) const { return VertexIndex >= 0 && VertexIndex < GetNumVertices(); }
+
+	SIZE_T GetAllocatedSize() const;
+};
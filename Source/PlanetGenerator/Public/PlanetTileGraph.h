@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Adjacency of the subdivided icosphere, stored in compressed sparse row (CSR) form.
+// Tiles are the mesh triangles, so tile indices match the triangle indices used by tile selection.
+// The neighbours of tile i are TileNeighbours[TileOffsets[i] .. TileOffsets[i + 1]), and likewise for vertices.
+struct PLANETGENERATOR_API FPlanetTileGraph
+{
+	TArray<int32> TileOffsets;
+	TArray<int32> TileNeighbours;
+
+	TArray<int32> VertexOffsets;
+	TArray<int32> VertexNeighbours;
+
+	// Centroid of each tile projected back onto the unit sphere
+	TArray<FVector> TileCenters;
+
+	// Builds the graph from the per-triangle edge neighbours emitted by the subdivision step.
+	// TriangleNeighbours[t * 3 + k] is the triangle across edge k (vertex k to vertex k + 1) of triangle t.
+	void Build(const TArray<FVector>& UnitVertices, const TArray<int32>& Triangles, const TArray<int32>& TriangleNeighbours);
+
+	void Reset();
+
+	SIZE_T GetAllocatedSize() const;
+
+	int32 GetNumTiles() const { return TileOffsets.Num() > 0 ? TileOffsets.Num() - 1 : 0; }
+	int32 GetNumVertices() const { return VertexOffsets.Num() > 0 ? VertexOffsets.Num() - 1 : 0; }
+
+	bool IsValidTile(int32 TileIndex) const { return TileIndex >= 0 && TileIndex < GetNumTiles(); }
+	bool IsValidVertex(int32 VertexIndex) const { return VertexIndex >= 0 && VertexIndex < GetNumVertices(); }
+
+	TArrayView<const int32> GetTileNeighbours(int32 TileIndex) const;
+	TArrayView<const int32> GetVertexNeighbours(int32 VertexIndex) const;
+
+	// Collects the tiles that are exactly Distance steps away from TileIndex (breadth-first layer)
+	void GetTileRing(int32 TileIndex, int32 Distance, TArray<int32>& OutTiles) const;
+
+	// Collects the connected tiles reachable from SeedTile through tiles accepted by Predicate(TileIndex)
+	template <typename PredicateType>
+	void FloodFill(int32 SeedTile, PredicateType Predicate, TArray<int32>& OutTiles) const
+	{
+		OutTiles.Reset();
+
+		if (!IsValidTile(SeedTile) || !Predicate(SeedTile))
+		{
+			return;
+		}
+
+		// OutTiles doubles as the breadth-first queue
+		TBitArray<> Visited(false, GetNumTiles());
+		Visited[SeedTile] = true;
+		OutTiles.Add(SeedTile);
+
+		for (int32 Head = 0; Head < OutTiles.Num(); Head++)
+		{
+			for (int32 Neighbour : GetTileNeighbours(OutTiles[Head]))
+			{
+				if (!Visited[Neighbour])
+				{
+					Visited[Neighbour] = true;
+					if (Predicate(Neighbour))
+					{
+						OutTiles.Add(Neighbour);
+					}
+				}
+			}
+		}
+	}
+
+	// Labels connected components where adjacent tiles belong together if SameRegion(TileA, TileB) holds.
+	// Labels are dense, starting at 0; returns the number of components.
+	int32 LabelComponents(TFunctionRef<bool(int32, int32)> SameRegion, TArray<int32>& OutLabels) const;
+};
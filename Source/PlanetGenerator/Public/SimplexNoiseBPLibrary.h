@@ -10,6 +10,9 @@ class PLANETGENERATOR_API USimplexNoiseBPLibrary : public UBlueprintFunctionLibr
 	GENERATED_BODY()
 
 public:
+	// Seed of the table used until SetNoiseSeed picks another
+	static constexpr int32 DefaultSeed = 1337;
+
 	// 1D Simplex Noise
 	UFUNCTION(BlueprintCallable, Category = "SimplexNoise")
 	static float SimplexNoise1D(float X);
@@ -22,6 +25,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "SimplexNoise")
 	static float SimplexNoise3D(float X, float Y, float Z);
 
+	// SimplexNoise3D on the DefaultSeed table, whatever SetNoiseSeed last picked. Planet builds
+	// sample this, so a reseed never reaches a build running on a worker; a planet's Seed moves
+	// its sample points instead.
+	static float SimplexNoise3DDefaultSeed(float X, float Y, float Z);
+
 	// 4D Simplex Noise
 	UFUNCTION(BlueprintCallable, Category = "SimplexNoise")
 	static float SimplexNoise4D(float X, float Y, float Z, float W);
@@ -30,7 +38,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "SimplexNoise")
 	static float SimplexNoiseFBM(float X, float Y, float Z, int32 Octaves, float Persistence, float Lacunarity);
 
-	// Set the seed for the noise
+	// SimplexNoise3D over many points; identical results, one table check per call
+	static void SimplexNoise3DBatch(TArrayView<const FVector> Points, TArrayView<float> OutValues);
+
+	// SimplexNoiseFBM over many points; identical results
+	static void SimplexNoiseFBMBatch(TArrayView<const FVector> Points, int32 Octaves, float Persistence, float Lacunarity, TArrayView<float> OutValues);
+
+	// Set the seed for the noise functions above. Safe to call while other threads sample noise;
+	// each call reads either the old table or the new one.
 	UFUNCTION(BlueprintCallable, Category = "SimplexNoise")
 	static void SetNoiseSeed(int32 NewSeed);
 };